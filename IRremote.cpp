@@ -26,6 +26,8 @@
 
 #ifndef IR_TIMER_USE_ESP32
 #include <avr/interrupt.h>
+#else
+extern hw_timer_t *timer;  // defined in irRecv.cpp
 #endif
 
 
@@ -38,10 +40,10 @@
 //   reason, no matter what I did I could not get them to function as macros again.
 // I have found a *lot* of bugs in the Arduino compiler over the last few weeks,
 //   and I am currently assuming that one of these bugs is my problem.
-// I may revisit this code at a later date and look at the assembler produced
-//   in a hope of finding out what is going on, but for now they will remain as
-//   functions even in non-DEBUG mode
+// Without DEBUG they are now inline functions in IRremote.h, which the
+//   compiler reduces to two integer compares; these are the DEBUG versions
 //
+#if DEBUG
 int  MATCH (int measured,  int desired)
 {
  	DBG_PRINT(F("Testing: "));
@@ -110,95 +112,530 @@ int  MATCH_SPACE (int measured_ticks,  int desired_us)
     DBG_PRINTLN(F("?; FAILED")); 
  	return passed;
 }
+#endif // DEBUG
+
+//+=============================================================================
+// The frame in irp.rawbuf is complete
+// If there is a free slot, queue the frame and carry on recording in to the
+//   next slot.  Otherwise stop the ISR until resume() frees one.
+// Called with interrupts disabled: from the ISRs, checkGap() and resume()
+//
+void  IR_ISR_ATTR  irFrameDone (volatile irparams_t &irp)
+{
+#if IR_MIN_ENTRIES
+	// Too short to be any code (resume() calls again only for a frame which was
+	//   kept): noise, so drop it and go back to waiting for a gap
+	if ((irp.rcvstate != STATE_STOP) && !irp.overflow && (irp.rawlen < IR_MIN_ENTRIES)) {
+#	if IR_STATS
+		irp.stats.runts++;
+#	endif
+		irp.rawlen   = 0;
+		irp.rcvstate = STATE_IDLE;
+		return;
+	}
+#endif
+
+#if IR_STATS
+	// resume() calls again for a frame which was waiting for a slot
+	if (irp.rcvstate != STATE_STOP) {
+		irp.stats.frames++;
+		if (irp.overflow)  irp.stats.overflows++ ;
+	}
+#endif
+
+#if (RAWBUF_FRAMES > 1)
+	// The caller's buffer is not part of the queue
+	if (!irp.userbuf && (irp.queued < RAWBUF_FRAMES - 1)) {
+		irp.framelen[irp.head] = irp.rawlen;
+		irp.frameovf[irp.head] = irp.overflow;
+		irp.queued++;
+
+		if (++irp.head >= RAWBUF_FRAMES)  irp.head = 0 ;
+		irp.rawbuf   = irp.frames[irp.head];
+		irp.rawlen   = 0;
+		irp.rcvstate = STATE_IDLE;
+		return;
+	}
+#endif
+	irp.rcvstate = STATE_STOP;
+}
+
+//+=============================================================================
+// Flash the blink LED to follow the receiver input
+// Shared by the timer and edge interrupt handlers
+//
+static inline  void  IR_ISR_ATTR  irBlink (volatile irparams_t &irp,  uint8_t input)
+{
+#ifdef IR_FAST_PINS
+	if (input == MARK)
+		if (irp.blinkpin) *irp.blinkreg |= irp.blinkmask; // Turn user defined pin LED on
+			else BLINKLED_ON() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+	else if (irp.blinkpin) *irp.blinkreg &= ~irp.blinkmask; // Turn user defined pin LED off
+			else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware off
+#else
+	if (input == MARK)
+		if (irp.blinkpin) digitalWrite(irp.blinkpin, HIGH); // Turn user defined pin LED on
+			else BLINKLED_ON() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+	else if (irp.blinkpin) digitalWrite(irp.blinkpin, LOW); // Turn user defined pin LED on
+			else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+#endif
+}
+
+//+=============================================================================
+// Read the receiver: SPACE [xmt LED off] or MARK [xmt LED on]
+// With IR_FAST_PINS, port is what was read from the receiver's port register
+// Shared by the timer and edge interrupt handlers
+//
+#ifdef IR_FAST_PINS
+static inline  uint8_t  IR_ISR_ATTR  irInput (volatile irparams_t &irp,  uint8_t port)
+{
+	if (port & irp.recvmask)
+#else
+static inline  uint8_t  IR_ISR_ATTR  irInput (volatile irparams_t &irp)
+{
+	if (digitalRead(irp.recvpin) == HIGH)
+#endif
+		return irp.inverted_input ? MARK : SPACE;
+	else
+		return irp.inverted_input ? SPACE : MARK;
+}
+
+//+=============================================================================
+// Append a duration to the frame being recorded
+// With IR_COMPACT_RAWBUF a duration too long for a byte goes in the side table;
+//   once that is full it is clipped to the longest that fits
+// Shared by the timer and edge interrupt handlers
+//
+static inline  void  IR_ISR_ATTR  irRecord (volatile irparams_t &irp,  unsigned int ticks)
+{
+#ifdef IR_COMPACT_RAWBUF
+	if (irp.rawlen == 0)  irp.nlongs = 0 ;  // First entry of a new frame
+	if (ticks >= RAWBUF_ESCAPE) {
+		if (irp.nlongs < RAWBUF_LONGS) {
+			irp.longs[irp.head][irp.nlongs] = ticks;
+			ticks = RAWBUF_ESCAPE + irp.nlongs++;
+		} else {
+			ticks = RAWBUF_ESCAPE - 1;
+		}
+	}
+#endif
+	irp.rawbuf[irp.rawlen++] = ticks;
+}
+
+#if IR_GLITCH_TICKS
+//+=============================================================================
+// The glitch filter
+// The mark or space which has just ended was only a spike of ticks, so it and
+//   the interval before it are all one interval, which is still going on:
+//   take that back off the frame, and return the length of the whole.
+// A spike straight after the gap puts the receiver back in the gap.
+// Shared by the timer and edge interrupt handlers
+//
+static inline  unsigned int  IR_ISR_ATTR  irGlitch (volatile irparams_t &irp,  unsigned int ticks)
+{
+	unsigned long  whole = irp.rawbuf[--irp.rawlen];
+
+#ifdef IR_COMPACT_RAWBUF
+	if (whole >= RAWBUF_ESCAPE)  whole = irp.longs[irp.head][--irp.nlongs] ;
+#endif
+	whole += ticks;
+
+	if      (irp.rawlen == 0)               irp.rcvstate = STATE_IDLE ;
+	else if (irp.rcvstate == STATE_MARK)    irp.rcvstate = STATE_SPACE ;
+	else                                    irp.rcvstate = STATE_MARK ;
+
+#if IR_STATS
+	irp.stats.glitches++;
+#endif
+	return (whole > 0xFFFF) ? 0xFFFF : whole ;
+}
+#endif
+
+#if IR_STATS
+//+=============================================================================
+// Count an interrupt, which took cycles, against a receiver
+//
+static inline  void  IR_ISR_ATTR  irStatISR (volatile irparams_t &irp,  unsigned long cycles)
+{
+	volatile irisrstats_t  &s = irp.stats;
+
+	if (!s.count || (cycles < s.min))  s.min = cycles ;
+	if (cycles > s.max)                s.max = cycles ;
+	if (!s.count)  s.avg16 = cycles << 4 ;
+	else           s.avg16 += cycles - (s.avg16 >> 4) ;
+	s.count++;
+}
+
+#	define IR_TIMED(irp, call)  do {                        \
+		unsigned long  t0 = IR_CYCLES();                   \
+		call;                                              \
+		irStatISR((irp), IR_CYCLES() - t0);                \
+	} while (0)
+
+#	ifdef TIMER_TICK_CYCLES
+//+=============================================================================
+// Cycles since t0, by the timer's count (boarddefs.h), in the timer ISR
+// Should the tick end meanwhile the count starts again from 0, so a count
+//   below t0 has gone round once; one going round more has lost a tick anyway
+//
+static inline  unsigned int  IR_ISR_ATTR  irTickCycles (unsigned int t0)
+{
+	unsigned int  t = TIMER_TICK_CYCLES();
+
+	if (t < t0)  t += TIMER_TICK_PERIOD() ;
+	return t - t0;
+}
+
+#		define IR_TIMED_TICK(irp, call)  do {                   \
+			unsigned int  t0 = TIMER_TICK_CYCLES();            \
+			call;                                              \
+			irStatISR((irp), irTickCycles(t0));                \
+		} while (0)
+#	else
+#		define IR_TIMED_TICK(irp, call)  IR_TIMED(irp, call)
+#	endif
+#else
+#	define IR_TIMED(irp, call)       call
+#	define IR_TIMED_TICK(irp, call)  call
+#endif
+
+//+=============================================================================
+// true if a receiver is being sampled by the timer ISR
+//
+bool  IR_ISR_ATTR  irTimerBusy ( )
+{
+	for (uint8_t r = 0;  r < irreceivers;  r++)
+		if (irrecvs[r].rcvstate && !irrecvs[r].edgemode && !irrecvs[r].asleep)  return true ;
+	return false;
+}
 
+#ifdef digitalPinToInterrupt
 //+=============================================================================
-// Interrupt Service Routine - Fires every 50uS
-// TIMER2 interrupt code to collect raw data.
+// Low power receiving (see IRrecv::lowPower())
+// After IR_SLEEP_USECS of silence, irTick() puts the receiver to sleep: the
+//   receive pin gets an interrupt, and if no other receiver needs it, the
+//   timer interrupt is stopped, so the MCU may sleep until IR arrives.
+//
+static void  IR_ISR_ATTR  irSleep (volatile irparams_t &irp)
+{
+#	ifndef IR_WAKE_ATTACHED
+	uint8_t  rx = &irp - irrecvs;
+#	endif
+
+	irp.asleep = true;
+	if (!irTimerBusy()) {
+#	ifdef IR_TIMER_USE_ESP32
+		timerAlarmDisable(timer);
+#	else
+		TIMER_DISABLE_INTR;
+#	endif
+	}
+#	ifndef IR_WAKE_ATTACHED
+	attachInterrupt(digitalPinToInterrupt(irp.recvpin), irEdgeISR[rx],
+	                irp.inverted_input ? RISING : IR_WAKE_TRIGGER);
+#	endif
+}
+
+//+=============================================================================
+// The first mark since irSleep(): record the gap and start the timer again
+// The mark began wakeusecs before now, while the MCU was waking up; the next
+//   tick times it from there, by micros(), rather than from that tick
+//
+static void  IR_ISR_ATTR  irWake (volatile irparams_t &irp,  unsigned long now)
+{
+	bool  stopped = !irTimerBusy();
+
+#	ifndef IR_WAKE_ATTACHED
+	detachInterrupt(digitalPinToInterrupt(irp.recvpin));
+#	endif
+	irp.asleep   = false;
+	irp.overflow = false;
+	irp.rawlen   = 0;
+	irRecord(irp, 0xFFFF);  // A long idle, as the timer would have clipped it
+	irp.lastedge = now - irp.wakeusecs;
+	irp.woken    = true;
+	irp.timer    = 0;
+	irp.rcvstate = STATE_MARK;
+
+	if (stopped) {
+#	ifdef IR_TIMER_USE_ESP32
+		timerAlarmEnable(timer);
+#	else
+		TIMER_ENABLE_INTR;
+		TIMER_RESET;
+#	endif
+	}
+}
+#endif
+
+//+=============================================================================
+// One tick of the timer ISR (below) for one receiver
 // Widths of alternating SPACE, MARK are recorded in rawbuf.
-// Recorded in ticks of 50uS [microseconds, 0.000050 seconds]
+// Recorded in ticks of USECPERTICK uS [microseconds]
 // 'rawlen' counts the number of entries recorded so far.
 // First entry is the SPACE between transmissions.
 // As soon as a the first [SPACE] entry gets long:
 //   Ready is set; State switches to IDLE; Timing of SPACE continues.
 // As soon as first MARK arrives:
 //   Gap width is recorded; Ready is cleared; New logging starts
+// With IR_GLITCH_TICKS, a MARK or SPACE no longer than that is merged by
+//   irGlitch() in to the interval either side of it.
+// In low power mode, a gap of IR_SLEEP_USECS puts the receiver to sleep until
+//   an edge calls irWake().
 //
-#ifdef IR_TIMER_USE_ESP32
-void IRTimer()
-#else
-ISR (TIMER_INTR_NAME)
-#endif
+static inline  void  IR_ISR_ATTR  irTick (volatile irparams_t &irp,  uint8_t input)
 {
-	TIMER_RESET;
-	uint8_t input;
-
-	// Read if IR Receiver -> SPACE [xmt LED off] or a MARK [xmt LED on]
-	// digitalRead() is very slow. Optimisation is possible, but makes the code unportable
-	if (digitalRead (irparams.recvpin) == HIGH)
-		input = irparams.inverted_input? MARK: SPACE;
-	else
-		input = irparams.inverted_input? SPACE: MARK;
+	if (irp.timer < 0xFFFF)  irp.timer++ ;  // One more tick, but don't wrap in a long idle
+	if (irp.rawlen >= irp.rawsize)  irp.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
 
-	irparams.timer++;  // One more 50uS tick
-	if (irparams.rawlen >= RAWBUF)  irparams.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
-
-	switch(irparams.rcvstate) {
+	switch(irp.rcvstate) {
 		//......................................................................
 		case STATE_IDLE: // In the middle of a gap
 			if (input == MARK) {
-				if (irparams.timer < GAP_TICKS)  {  // Not big enough to be a gap.
-					irparams.timer = 0;
+				if (irp.timer < GAP_TICKS)  {  // Not big enough to be a gap.
+					irp.timer = 0;
 
 				} else {
 					// Gap just ended; Record duration; Start recording transmission
-					irparams.overflow                  = false;
-					irparams.rawlen                    = 0;
-					irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-					irparams.timer                     = 0;
-					irparams.rcvstate                  = STATE_MARK;
+					irp.overflow                  = false;
+					irp.rawlen                    = 0;
+					irRecord(irp, irp.timer);
+					irp.timer                     = 0;
+					irp.rcvstate                  = STATE_MARK;
 				}
 			}
+#ifdef digitalPinToInterrupt
+			else if (irp.lowpower && (irp.timer >= SLEEP_TICKS))  irSleep(irp) ;
+#endif
 			break;
 		//......................................................................
 		case STATE_MARK:  // Timing Mark
+			if (irp.woken) {  // Woken by this mark: it began at lastedge
+				irp.woken = false;
+				irp.timer = (micros() - irp.lastedge) / USECPERTICK;
+			}
 			if (input == SPACE) {   // Mark ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_SPACE;
+#if IR_GLITCH_TICKS
+				if (irp.timer <= IR_GLITCH_TICKS) {  // Just a spike: the space goes on
+					irp.timer = irGlitch(irp, irp.timer);
+					break;
+				}
+#endif
+				irRecord(irp, irp.timer);
+				irp.timer                     = 0;
+				irp.rcvstate                  = STATE_SPACE;
+				if (irp.early && irEarlyEnd(irp))  irFrameDone(irp) ;  // Last mark of the frame
 			}
 			break;
 		//......................................................................
 		case STATE_SPACE:  // Timing Space
 			if (input == MARK) {  // Space just ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_MARK;
+#if IR_GLITCH_TICKS
+				if (irp.timer <= IR_GLITCH_TICKS) {  // Just a dropout: the mark goes on
+					irp.timer = irGlitch(irp, irp.timer);
+					break;
+				}
+#endif
+				irRecord(irp, irp.timer);
+				irp.timer                     = 0;
+				irp.rcvstate                  = STATE_MARK;
 
-			} else if (irparams.timer > GAP_TICKS) {  // Space
+			} else if (irp.timer > GAP_TICKS) {  // Space
 					// A long Space, indicates gap between codes
 					// Flag the current code as ready for processing
-					// Switch to STOP
+					// Queue it, or switch to STOP if there is no free slot
 					// Don't reset timer; keep counting Space width
-					irparams.rcvstate = STATE_STOP;
+					irFrameDone(irp);
 			}
 			break;
 		//......................................................................
 		case STATE_STOP:  // Waiting; Measuring Gap
-			if (input == MARK)  irparams.timer = 0 ;  // Reset gap timer
+			if (input == MARK) {
+				if (irp.timer >= GAP_TICKS)  irp.overruns++ ;  // A new code we have no room for
+				irp.timer = 0;  // Reset gap timer
+			}
 		 	break;
 		//......................................................................
 		case STATE_OVERFLOW:  // Flag up a read overflow; Stop the State Machine
-			irparams.overflow = true;
-			irparams.rcvstate = STATE_STOP;
+			irp.overflow = true;
+			irFrameDone(irp);
 		 	break;
 	}
 
 	// If requested, flash LED while receiving IR data
-	if (irparams.blinkflag) {
-		if (input == MARK)
-			if (irparams.blinkpin) digitalWrite(irparams.blinkpin, HIGH); // Turn user defined pin LED on
-				else BLINKLED_ON() ;   // if no user defined LED pin, turn default LED pin for the hardware on
-		else if (irparams.blinkpin) digitalWrite(irparams.blinkpin, LOW); // Turn user defined pin LED on
-				else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+	if (irp.blinkflag)  irBlink(irp, input) ;
+}
+
+//+=============================================================================
+// Interrupt Service Routine - Fires every USECPERTICK uS (50uS by default)
+// TIMER2 interrupt code to collect raw data, for every receiver using it
+//
+#ifdef IR_TIMER_USE_ESP32
+void IR_ISR_ATTR IRTimer()
+#else
+ISR (TIMER_INTR_NAME)
+#endif
+{
+#ifdef IR_FAST_PINS
+	volatile uint8_t  *reg  = NULL;
+	uint8_t            port = 0;
+#endif
+
+	TIMER_RESET;
+
+	// One tick for each receiver which is using the timer
+	for (uint8_t r = 0;  r < IR_RECEIVERS;  r++) {
+		volatile irparams_t  &irp = irrecvs[r];
+		if (irp.edgemode || !irp.rcvstate || irp.asleep)  continue ;  // Not using the timer, not started, or asleep
+
+		// Read if IR Receiver -> SPACE [xmt LED off] or a MARK [xmt LED on]
+		// digitalRead() is very slow, so where we can we read the port (IR_FAST_PINS);
+		//   receivers on the same port share one read, which also samples them together
+#ifdef IR_FAST_PINS
+		if (irp.recvreg != reg)  port = *(reg = irp.recvreg) ;
+		IR_TIMED_TICK(irp, irTick(irp, irInput(irp, port)));
+#else
+		IR_TIMED_TICK(irp, irTick(irp, irInput(irp)));
+#endif
 	}
 }
+
+//+=============================================================================
+// Interrupt Service Routine - Fires on every edge of the receiver pin
+// Used instead of the timer ISR when enableIRIn() is asked for IR_RECV_EDGE.
+// The width of each SPACE and MARK is taken from micros() and converted to
+//   USECPERTICK ticks, so rawbuf is filled exactly as the timer ISR fills it.
+// There is no edge at the end of a transmission, so the trailing gap is
+//   spotted by IRrecv::checkGap() when decode() or isIdle() are called,
+//   or failing that, by the first edge of the next transmission.
+// A level which does not match the state (an edge lost to a very short glitch)
+//   is not an interval of its own and is counted in to the current one.
+// With IR_GLITCH_TICKS, an interval that short which does have both its edges
+//   is taken back out of rawbuf in the same way, by irGlitch().
+// The timer is free for IRsend, so codes can be received while sending; see
+//   IRrecv::maskEcho() to ignore our own transmission.
+// A receiver sampled by the timer only has the interrupt while it is asleep in
+//   low power mode, and only its wake up edge is used.
+//
+static inline  void  IR_ISR_ATTR  irEdge (volatile irparams_t &irp)
+{
+	unsigned long  now   = micros();
+	unsigned long  usecs = now - irp.lastedge;
+	unsigned int   ticks;
+#ifdef IR_FAST_PINS
+	uint8_t        input = irInput(irp, *irp.recvreg);
+#else
+	uint8_t        input = irInput(irp);
+#endif
+
+#ifdef digitalPinToInterrupt
+	if (!irp.edgemode) {
+		if (irp.asleep && (input == MARK))  irWake(irp, now) ;
+		return;
+	}
+#endif
+
+	// While we are sending, and for a moment after, the detector may be seeing
+	//   our own LED; whatever we were capturing is spoilt, so drop it
+	// irtxon first: irtxoff is only safe to read once it is false (irSend.cpp)
+	if (irp.echomask && (irtxon || (now - irtxoff < ECHO_USECS))) {
+		if ((irp.rcvstate == STATE_MARK) || (irp.rcvstate == STATE_SPACE)) {
+			irp.rawlen   = 0;
+			irp.rcvstate = STATE_IDLE;
+		}
+		irp.lastedge = now;
+		return;
+	}
+
+	// Marks & Spaces fit in 16 bits, only a gap needs the (slow) long division
+	if      (usecs < 0x8000)                  ticks = ((unsigned int)usecs + (USECPERTICK / 2)) / USECPERTICK ;
+	else if (usecs < 0xFFFFUL * USECPERTICK)  ticks = usecs / USECPERTICK ;
+	else                                      ticks = 0xFFFF ;
+
+	// If nobody called checkGap() during the gap after the last code,
+	//   this is the first edge of the next one: close the last code now
+	if ((irp.rcvstate == STATE_SPACE) && (usecs > _GAP))  irFrameDone(irp) ;
+
+	switch(irp.rcvstate) {
+		//......................................................................
+		case STATE_IDLE: // In the middle of a gap
+			if ((input == MARK) && (usecs >= _GAP)) {
+				// Gap just ended; Record duration; Start recording transmission
+				irp.overflow                  = false;
+				irp.rawlen                    = 0;
+				irRecord(irp, ticks);
+				irp.rcvstate                  = STATE_MARK;
+			}
+			irp.lastedge = now;  // Any activity restarts the gap
+			break;
+		//......................................................................
+		case STATE_MARK:  // Timing Mark
+			if (input == SPACE) {   // Mark ended; Record time
+#if IR_GLITCH_TICKS
+				if (ticks <= IR_GLITCH_TICKS) {  // Just a spike: the space goes on, from when it began
+					irp.lastedge = now - (unsigned long)irGlitch(irp, ticks) * USECPERTICK;
+					break;
+				}
+#endif
+				irRecord(irp, ticks);
+				irp.lastedge                  = now;
+				irp.rcvstate                  = STATE_SPACE;
+				if (irp.early && irEarlyEnd(irp))  irFrameDone(irp) ;  // Last mark of the frame
+			}
+			break;
+		//......................................................................
+		case STATE_SPACE:  // Timing Space
+			if (input == MARK) {  // Space just ended; Record time
+#if IR_GLITCH_TICKS
+				if (ticks <= IR_GLITCH_TICKS) {  // Just a dropout: the mark goes on, from when it began
+					irp.lastedge = now - (unsigned long)irGlitch(irp, ticks) * USECPERTICK;
+					break;
+				}
+#endif
+				irRecord(irp, ticks);
+				irp.lastedge                  = now;
+				irp.rcvstate                  = STATE_MARK;
+			}
+			break;
+		//......................................................................
+		case STATE_STOP:  // Waiting; Measuring Gap
+			if ((input == MARK) && (usecs >= _GAP))  irp.overruns++ ;  // A new code we have no room for
+			irp.lastedge = now;
+		 	break;
+	}
+
+	// There is no next tick to notice the overflow, so stop straight away
+	if (((irp.rcvstate == STATE_MARK) || (irp.rcvstate == STATE_SPACE))
+	    && (irp.rawlen >= irp.rawsize)) {
+		irp.overflow = true;
+		irFrameDone(irp);
+	}
+
+	// If requested, flash LED while receiving IR data
+	if (irp.blinkflag)  irBlink(irp, input) ;
+}
+
+// attachInterrupt() handlers take no arguments, so there is one per receiver
+void  IR_ISR_ATTR  IRedge  ( )  { IR_TIMED(irrecvs[0], irEdge(irrecvs[0])); }
+#if (IR_RECEIVERS > 1)
+void  IR_ISR_ATTR  IRedge1 ( )  { IR_TIMED(irrecvs[1], irEdge(irrecvs[1])); }
+#endif
+#if (IR_RECEIVERS > 2)
+void  IR_ISR_ATTR  IRedge2 ( )  { IR_TIMED(irrecvs[2], irEdge(irrecvs[2])); }
+#endif
+#if (IR_RECEIVERS > 3)
+void  IR_ISR_ATTR  IRedge3 ( )  { IR_TIMED(irrecvs[3], irEdge(irrecvs[3])); }
+#endif
+
+void (* const irEdgeISR[IR_RECEIVERS])() = {
+	IRedge,
+#if (IR_RECEIVERS > 1)
+	IRedge1,
+#endif
+#if (IR_RECEIVERS > 2)
+	IRedge2,
+#endif
+#if (IR_RECEIVERS > 3)
+	IRedge3,
+#endif
+};
@@ -83,7 +83,7 @@
 # define DECODE_RSTEP        1
 #endif
 #ifndef SEND_RSTEP
-# define SEND_RSTEP          0 // NOT WRITTEN
+# define SEND_RSTEP          1
 #endif
 
 //------------------------------------------------------------------------------
@@ -101,6 +101,124 @@
 #define PRONTO_FALLBACK    true
 #define PRONTO_NOFALLBACK  false
 
+// A Pronto code parsed by IRsend::compilePronto(), ready to be sent again and
+//   again; the durations are in a buffer supplied by the caller
+typedef
+	struct {
+		unsigned long  hz;    // Carrier frequency
+		unsigned int   once;  // Mark/space pairs of the "once" code, from data[0]
+		unsigned int   rpt;   // Mark/space pairs of the "repeat" code, from data[2*once]
+		unsigned int  *data;  // Marks & spaces, in uS
+	}
+ProntoCode;
+
+// A code rendered by IRsend::encode(), for IRsend::sendSequence();
+//   the marks & spaces are in a buffer supplied by the caller
+typedef
+	struct {
+		unsigned long  hz;    // Carrier frequency
+		uint8_t        duty;  // ... and duty cycle, as for IRsend::enableIROutHz()
+		unsigned int   len;   // Marks & spaces in data
+		unsigned long  gap;   // uS to leave before the next code of a sequence
+		unsigned int  *data;  // Marks & spaces, in uS, as for sendRaw()
+	}
+IRframe;
+
+// The gap after a code of a protocol with no set repeat period
+#ifndef IR_FRAME_GAP
+#	define IR_FRAME_GAP  40000  // uS
+#endif
+
+//------------------------------------------------------------------------------
+// Tick windows for the bits of a pulse distance or pulse width code
+// Fill them in with PULSE_DISTANCE() or PULSE_WIDTH() and constant timings,
+//   so the compiler works the windows out rather than the decoder
+//
+typedef
+	struct {
+		int  fixed_low, fixed_high;  // The entry which is the same for every bit
+		int  one_low,   one_high;    // The entry for a one
+		int  zero_low,  zero_high;   // The entry for a zero
+	}
+bit_timing_t;
+
+#define MARK_WINDOW(us)   TICKS_LOW((us) + MARK_EXCESS), TICKS_HIGH((us) + MARK_EXCESS)
+#define SPACE_WINDOW(us)  TICKS_LOW((us) - MARK_EXCESS), TICKS_HIGH((us) - MARK_EXCESS)
+
+// Each bit is a fixed mark followed by a one or zero space
+#define PULSE_DISTANCE(mark, one_space, zero_space) \
+	{ MARK_WINDOW(mark), SPACE_WINDOW(one_space), SPACE_WINDOW(zero_space) }
+
+// Each bit is a fixed space followed by a one or zero mark
+#define PULSE_WIDTH(space, one_mark, zero_mark) \
+	{ SPACE_WINDOW(space), MARK_WINDOW(one_mark), MARK_WINDOW(zero_mark) }
+
+//------------------------------------------------------------------------------
+// A protocol described by a table rather than by code, for the one encoder
+//   (IRsend::sendProtocol()) and decoder (IRrecv::decodeProtocol()) in
+//   irProtocol.cpp.  It fits any pulse distance or pulse width code; build it
+//   with IR_PROTOCOL(), which also works out its tick windows, and put it in
+//   flash, eg.
+//     const ir_protocol_t  SHUZU_PROTOCOL PROGMEM = IR_PROTOCOL(SHUZU, 38, 32, 0, ...);
+// All times are in uS
+//
+#define IR_PROTO_PULSE_WIDTH  0x01  // Bits are a fixed space then a one or zero mark,
+                                    //   rather than a fixed mark then a one or zero space
+#define IR_PROTO_LSB_FIRST    0x02  // Least significant bit sent first
+#define IR_PROTO_START_BIT    0x04  // A zero bit comes before the header
+#define IR_PROTO_RPT_NOHDR    0x08  // A repeat is the frame without its header (JVC)
+#define IR_PROTO_EXACT_LEN    0x10  // Nothing may follow the frame
+
+typedef
+	struct {
+		int8_t         type;       // decode_type_t for decodeProtocol() to report
+		uint8_t        khz;        // Carrier frequency
+		uint8_t        bits;       // Data bits in a frame, at most 32
+		uint8_t        flags;      // IR_PROTO_...
+		unsigned int   hdr_mark;   // Header, 0 for none
+		unsigned int   hdr_space;  // ... 0 for none
+		unsigned int   bit_fixed;  // The mark (or space) which is the same for every bit
+		unsigned int   bit_one;    // The space (or mark) for a one
+		unsigned int   bit_zero;   // ... and for a zero
+		unsigned int   footer;     // Trailing mark, 0 for none
+		unsigned int   rpt_space;  // A repeat is hdr_mark, rpt_space, bit_fixed (NEC, so a pulse
+		                           //   distance code); 0 for none
+		unsigned long  period;     // From the start of one frame to the next; 0 for IR_FRAME_GAP
+		int            hdr_mark_low,  hdr_mark_high;   // Tick windows of the above,
+		int            hdr_space_low, hdr_space_high;  //   for decodeProtocol()
+		int            footer_low,    footer_high;
+		int            rpt_space_low, rpt_space_high;
+		bit_timing_t   bit;
+	}
+ir_protocol_t;
+
+// A duration's window as a mark, or as a space
+#define IR_PROTO_WINDOW(mark, us)  \
+	TICKS_LOW((mark) ? (us) + MARK_EXCESS : (us) - MARK_EXCESS), \
+	TICKS_HIGH((mark) ? (us) + MARK_EXCESS : (us) - MARK_EXCESS)
+
+#define IR_PROTOCOL(type, khz, bits, flags, hdr_mark, hdr_space, bit_fixed, bit_one, bit_zero, footer, rpt_space, period) \
+	{ type, khz, bits, flags, hdr_mark, hdr_space, bit_fixed, bit_one, bit_zero, footer, rpt_space, period, \
+	  MARK_WINDOW(hdr_mark), SPACE_WINDOW(hdr_space), MARK_WINDOW(footer), SPACE_WINDOW(rpt_space), \
+	  { IR_PROTO_WINDOW(!((flags) & IR_PROTO_PULSE_WIDTH), bit_fixed), \
+	    IR_PROTO_WINDOW((flags) & IR_PROTO_PULSE_WIDTH, bit_one), \
+	    IR_PROTO_WINDOW((flags) & IR_PROTO_PULSE_WIDTH, bit_zero) } }
+
+//------------------------------------------------------------------------------
+// The receiver can either sample the input pin on a timer interrupt (every
+//   USECPERTICK uS, see boarddefs.h), or only take an interrupt when the input pin changes level
+//
+// The edge engine needs a pin which supports attachInterrupt()
+//   (eg. pins 2 & 3 on an Uno, any pin on ESP32)
+// If the pin does not support it, enableIRIn() falls back to the timer
+//
+// The timer is also used by IRsend, so the timer engine stops whenever a code
+//   is sent and you must call enableIRIn() again afterwards.
+// The edge engine keeps on receiving while you send.
+//
+#define IR_RECV_TIMER      false
+#define IR_RECV_EDGE       true
+
 //------------------------------------------------------------------------------
 // An enumerated list of all supported formats
 // You do NOT need to remove entries from this list when disabling protocols!
@@ -127,6 +245,7 @@ typedef
 		PRONTO,
 		LEGO_PF,
 		RSTEP,
+		DECODE_TYPES,  // Not a protocol: one past the last, so add new ones above
 	}
 decode_type_t;
 
@@ -146,12 +265,86 @@ decode_type_t;
 #	define DBG_PRINTLN(...)  do { } while (0)
 #endif
 
+//------------------------------------------------------------------------------
+// What the receiver has cost, with IR_STATS; see IRrecv::stats()
+// Times are in CPU cycles (see IR_CYCLES() in boarddefs.h)
+//
+#if IR_STATS
+#	define IR_STAT_TYPES  (DECODE_TYPES + 1)  // Decoders by decode_type + 1; [0] is decodeHash()
+
+typedef
+	struct {
+		unsigned long  isrCount;                // Interrupts: timer ticks, or edges
+		unsigned long  isrMin;                  // Cycles the quickest took
+		unsigned long  isrMax;                  // ... and the slowest
+		unsigned long  isrAvg;                  // ... and on average, lately
+		unsigned long  frames;                  // Frames recorded
+		unsigned long  overflows;               // Frames too long for the buffer
+		unsigned long  glitches;                // Spikes merged away (IR_GLITCH_TICKS)
+		unsigned long  runts;                   // Frames dropped as too short (IR_MIN_ENTRIES)
+		unsigned int   dropped;                 // Frames lost as every slot was full
+		unsigned int   tries[IR_STAT_TYPES];    // Times each decoder was tried
+		unsigned int   hits[IR_STAT_TYPES];     // ... and worked
+		unsigned long  cycles[IR_STAT_TYPES];   // ... and the cycles it took, in all
+	}
+irstats_t;
+#endif
+
 //------------------------------------------------------------------------------
 // Mark & Space matching functions
+// The decoders pass their timings as constants, so once inlined each match
+//   is just two integer compares against precomputed tick limits
+// With DEBUG they are out of line (in IRremote.cpp) so they can report
 //
+#if DEBUG
 int  MATCH       (int measured, int desired) ;
 int  MATCH_MARK  (int measured_ticks, int desired_us) ;
 int  MATCH_SPACE (int measured_ticks, int desired_us) ;
+#else
+inline  int  MATCH (int measured,  int desired)
+{
+	return (measured >= TICKS_LOW(desired)) && (measured <= TICKS_HIGH(desired));
+}
+
+// Due to sensor lag, when received, Marks tend to be 100us too long
+inline  int  MATCH_MARK (int measured_ticks,  int desired_us)
+{
+	return MATCH(measured_ticks, desired_us + MARK_EXCESS);
+}
+
+// Due to sensor lag, when received, Spaces tend to be 100us too short
+inline  int  MATCH_SPACE (int measured_ticks,  int desired_us)
+{
+	return MATCH(measured_ticks, desired_us - MARK_EXCESS);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Compact raw buffer: define IR_COMPACT_RAWBUF to record each duration in a
+//   byte rather than an int, which halves the RAM a frame takes.
+// The few durations too long for a byte (the leading gap, long headers) are
+//   kept in a small side table, and the byte holds RAWBUF_ESCAPE + their index.
+// decode_results::rawbuf[] reads either kind of entry back as ticks.
+// RAWBUF_ESCAPE and RAWBUF_LONGS are in IRremoteInt.h
+//
+#ifdef IR_COMPACT_RAWBUF
+class rawbuf_t
+{
+	public:
+		rawbuf_t ( )  : buf(0), longs(0)  { }
+		rawbuf_t (volatile uint8_t *b, volatile unsigned int *l)  : buf(b), longs(l)  { }
+
+		unsigned int  operator[] (int i) const
+		{
+			uint8_t  b = buf[i];
+			return (b < RAWBUF_ESCAPE) ? b : longs[b - RAWBUF_ESCAPE];
+		}
+
+	private:
+		volatile uint8_t       *buf;
+		volatile unsigned int  *longs;
+};
+#endif
 
 //------------------------------------------------------------------------------
 // Results returned from the decoder
@@ -163,16 +356,67 @@ class decode_results
 		unsigned int           address;      // Used by Panasonic & Sharp [16-bits]
 		unsigned long          value;        // Decoded value [max 32-bits]
 		int                    bits;         // Number of bits in decoded value
-		volatile unsigned int  *rawbuf;      // Raw intervals in 50uS ticks
+#ifdef IR_COMPACT_RAWBUF
+		rawbuf_t               rawbuf;       // Raw intervals in USECPERTICK ticks
+#else
+		volatile unsigned int  *rawbuf;      // Raw intervals in USECPERTICK ticks
+#endif
 		int                    rawlen;       // Number of records in rawbuf
 		int                    overflow;     // true iff IR raw code too long
 };
 
+//------------------------------------------------------------------------------
+// Bit for a protocol in the set of decoders IRrecv::decode() will try
+//
+#define CANDIDATE(type)  (1UL << (type))
+
 //------------------------------------------------------------------------------
 // Decoded value for NEC when a repeat code is received
 //
 #define REPEAT 0xFFFFFFFF
 
+//------------------------------------------------------------------------------
+// A code no decoder knows is returned as UNKNOWN, with a hash of its timings
+// DECODE_HASH_BITS sets the width of the hash, 16 or 32
+// With DECODE_HASH_QUANTIZE each mark & space is hashed as the class of
+//   similar lengths it falls in, so a noisy interval changes at most its own
+//   class.  Without it you get the hashes of older releases: whether each is
+//   shorter, the same or longer than the one before.
+//
+#ifndef DECODE_HASH_BITS
+#	define DECODE_HASH_BITS      32
+#endif
+#ifndef DECODE_HASH_QUANTIZE
+#	define DECODE_HASH_QUANTIZE  0
+#endif
+
+// Reads a byte of a library of learned codes, eg. from EEPROM; see irLearn.cpp
+typedef  uint8_t (*learned_read_t)(unsigned int addr) ;
+
+// The action for the hash of a learned code; see IRrecv::findHash()
+typedef
+	struct {
+		unsigned long  hash;
+		int            action;
+	}
+hash_action_t;
+
+//------------------------------------------------------------------------------
+// Button events from IRrecv::decodeKey()
+// A key is released when another key comes, or no frame of it has for
+//   IR_KEY_RELEASE_MS; that must be longer than the repeat interval of the
+//   remote (NEC 108mS, RC5 114mS).  A frame no decoder knows (UNKNOWN) while
+//   a known key is down is taken for noise, and does neither.
+//
+#define IR_KEY_NONE     0
+#define IR_KEY_PRESS    1
+#define IR_KEY_HOLD     2
+#define IR_KEY_RELEASE  3
+
+#ifndef IR_KEY_RELEASE_MS
+#	define IR_KEY_RELEASE_MS  150
+#endif
+
 //------------------------------------------------------------------------------
 // Main class for receiving IR
 //
@@ -185,14 +429,86 @@ class IRrecv
 		IRrecv (int recvpin, int blinkpin, bool inverted_input);
 
 		void  blink13    (int blinkflag) ;
+		void  maskEcho   (bool mask) ;
+		void  earlyEnd   (unsigned long protocols) ;
+		void  useBuffer  (volatile rawentry_t *buf,  unsigned int size) ;
 		int   decode     (decode_results *results) ;
-		void  enableIRIn ( ) ;
+		void  enableIRIn (bool edge = IR_RECV_TIMER) ;
 		bool  isIdle     ( ) ;
 		void  resume     ( ) ;
+		bool  lowPower   (bool on,  unsigned int wakeUsecs = 0) ;
+		bool  isAsleep   ( ) ;
+		unsigned int  overruns ( ) ;
+
+		int            decodeKey  (decode_results *results) ;  // IR_KEY_PRESS, _HOLD, _RELEASE or _NONE
+		unsigned long  keyHeld    ( ) ;                        // mS
+#		if IR_STATS
+			void  stats      (irstats_t *stats) ;
+			void  clearStats ( ) ;
+#		endif
+
+		// The action for an UNKNOWN code in a table sorted by hash, or -1
+		int   findHash   (const decode_results *results,  const hash_action_t table[],  unsigned int count) ;
+		int   findHash_P (const decode_results *results,  const hash_action_t table[],  unsigned int count) ;  // table in PROGMEM
+
+		// Which learned code (button) is this, or -1; see irLearn.cpp
+		int            findLearned   (const decode_results *results,  const uint8_t *image) ;
+		int            findLearned_P (const decode_results *results,  const uint8_t *image) ;  // image in PROGMEM
+		int            findLearned   (const decode_results *results,  learned_read_t read) ;
+		unsigned int   learn         (const decode_results *results,  int action,  uint8_t *image,  unsigned int size) ;
+
+		// Decode the frame decode() returned as a table driven protocol, eg. one
+		//   a sketch adds; see irProtocol.cpp
+		bool  decodeProtocol (decode_results *results,  const ir_protocol_t *proto) ;  // proto in PROGMEM
+
+	protected:
+		// For IRrecvT (below), which picks its own decoders
+		bool           fetch      (decode_results *results) ;
+		unsigned long  candidates (decode_results *results) ;
+
+		// decodeKey() with the given decode() and decodeAs()
+		typedef int   (*key_decode_t)    (IRrecv &r,  decode_results *results) ;
+		typedef bool  (*key_decode_as_t) (IRrecv &r,  decode_type_t type,  decode_results *results) ;
+		int  keyDecode (decode_results *results,  key_decode_t dec,  key_decode_as_t decAs) ;
+
+		template <decode_type_t>  friend struct IRdecoder ;
 
 	private:
+		uint8_t  rx;  // Our receiver state: irrecvs[rx]
+
+		// The key decodeKey() is following
+		bool           keyDown;
+		decode_type_t  keyType;
+		unsigned long  keyValue;
+		unsigned int   keyAddress;
+		int            keyBits;
+		int            keyLen;      // rawlen of its frames
+		unsigned long  keyStart;    // millis() when it was pressed
+		unsigned long  keyLast;     // ... and of its latest frame
+
+		void  init       (int recvpin,  int blinkpin,  bool inverted_input) ;
+		bool  decodeAs   (decode_type_t type,  decode_results *results) ;
+		bool  keyRepeat  (decode_results *results,  key_decode_as_t decAs) ;
+		static int   decodeAll   (IRrecv &r,  decode_results *results) ;
+		static bool  decodeAsAll (IRrecv &r,  decode_type_t type,  decode_results *results) ;
+		void  keyResults (decode_results *results) ;
+#		if IR_STATS
+			irstats_t  decstats;  // The decoder counts; the ISR keeps the rest
+#		endif
+
+		void  checkGap   ( ) ;
 		long  decodeHash (decode_results *results) ;
 		int   compare    (unsigned int oldval, unsigned int newval) ;
+		unsigned long  learnedHash (const decode_results *results) ;
+		int            learnedFind (const decode_results *results,  const uint8_t *image,
+		                            learned_read_t read,  bool pgm) ;
+
+		//......................................................................
+		// These helpers are shared by the pulse distance & pulse width decoders
+		bool  decodePulseDistance (decode_results *results,  int *offset,  int nbits,
+		                           const bit_timing_t *bit,  unsigned long *data) ;
+		bool  decodePulseWidth    (decode_results *results,  int *offset,
+		                           const bit_timing_t *bit,  unsigned long *data) ;
 
 		//......................................................................
 #		if (DECODE_RC5 || DECODE_RC6)
@@ -267,19 +583,210 @@ class IRrecv
 #		endif
 } ;
 
+//------------------------------------------------------------------------------
+// A receiver whose decoders are chosen by the sketch, at compile time, eg.
+//   IRrecvT<NEC, SONY, RC5>  irrecv(RECV_PIN);
+// decode() and decodeKey() try just those, in that order, and the others are
+//   not linked in (as long as nothing calls IRrecv::decode()).  Put UNKNOWN
+//   last to get a hash of any code the others do not know.  Only protocols
+//   with their DECODE_ switch on can be chosen.  This needs C++11 (Arduino
+//   1.6.6 on).
+//
+#if (__cplusplus >= 201103L)
+template <decode_type_t P>  struct IRdecoder ;  // One for each decoder, below
+
+#define IR_DECODER(type, name)                                                        \
+	template <>  struct IRdecoder<type> {                                             \
+		static bool  decode (IRrecv &r,  decode_results *results,  unsigned long cand) \
+		{                                                                             \
+			return (cand & CANDIDATE(type)) && r.name(results);                       \
+		}                                                                             \
+	}
+
+#if DECODE_NEC
+	IR_DECODER(NEC, decodeNEC);
+#endif
+#if DECODE_SONY
+	IR_DECODER(SONY, decodeSony);
+#endif
+#if DECODE_SANYO
+	IR_DECODER(SANYO, decodeSanyo);
+#endif
+#if DECODE_MITSUBISHI
+	IR_DECODER(MITSUBISHI, decodeMitsubishi);
+#endif
+#if DECODE_RC5
+	IR_DECODER(RC5, decodeRC5);
+#endif
+#if DECODE_RC6
+	IR_DECODER(RC6, decodeRC6);
+#endif
+#if DECODE_PANASONIC
+	IR_DECODER(PANASONIC, decodePanasonic);
+#endif
+#if DECODE_LG
+	IR_DECODER(LG, decodeLG);
+#endif
+#if DECODE_JVC
+	IR_DECODER(JVC, decodeJVC);
+#endif
+#if DECODE_SAMSUNG
+	IR_DECODER(SAMSUNG, decodeSAMSUNG);
+#endif
+#if DECODE_WHYNTER
+	IR_DECODER(WHYNTER, decodeWhynter);
+#endif
+#if DECODE_AIWA_RC_T501
+	IR_DECODER(AIWA_RC_T501, decodeAiwaRCT501);
+#endif
+#if DECODE_DENON
+	IR_DECODER(DENON, decodeDenon);
+#endif
+#if DECODE_RSTEP
+	IR_DECODER(RSTEP, decodeRstep);
+#endif
+#if DECODE_LEGO_PF
+	IR_DECODER(LEGO_PF, decodeLegoPowerFunctions);
+#endif
+
+// decodeHash() takes anything, so it is not one of the candidates
+template <>  struct IRdecoder<UNKNOWN> {
+	static bool  decode (IRrecv &r,  decode_results *results,  unsigned long)
+	{
+		return r.decodeHash(results);
+	}
+};
+
+template <decode_type_t... P>
+class IRrecvT : public IRrecv
+{
+	static_assert(sizeof...(P) > 0, "IRrecvT needs at least one protocol, eg. IRrecvT<NEC>");
+
+	public:
+		IRrecvT (int recvpin)                                         : IRrecv(recvpin) { }
+		IRrecvT (int recvpin,  bool inverted_input)                   : IRrecv(recvpin, inverted_input) { }
+		IRrecvT (int recvpin,  int blinkpin)                          : IRrecv(recvpin, blinkpin) { }
+		IRrecvT (int recvpin,  int blinkpin,  bool inverted_input)    : IRrecv(recvpin, blinkpin, inverted_input) { }
+
+		int  decode (decode_results *results)
+		{
+			if (!fetch(results))  return false ;
+
+			// Each decoder in turn, until one works
+			unsigned long  cand   = candidates(results);
+			bool           done   = false;
+			bool           each[] = { false, (done = done || IRdecoder<P>::decode(*this, results, cand))... };
+			(void)each;
+
+			if (done)  return true ;
+			resume();
+			return false;
+		}
+
+		int  decodeKey (decode_results *results)
+		{
+			return keyDecode(results, &decodeThese, &decodeAsThese);
+		}
+
+	private:
+		static int  decodeThese (IRrecv &r,  decode_results *results)
+		{
+			return static_cast<IRrecvT &>(r).decode(results);
+		}
+
+		// Just the decoder of type, if it is one of these
+		static bool  decodeAsThese (IRrecv &r,  decode_type_t type,  decode_results *results)
+		{
+			bool  done   = false;
+			bool  each[] = { false, (done = done || ((P == type) && IRdecoder<P>::decode(r, results, ~0UL)))... };
+			(void)each;
+
+			return done;
+		}
+};
+#endif
+
+//------------------------------------------------------------------------------
+// Duty cycles for IRsend::enableIROutHz(), in percent; any other will do too
+//
+#define IR_DUTY_25  25
+#define IR_DUTY_33  33  // As enableIROut()
+#define IR_DUTY_50  50
+
 //------------------------------------------------------------------------------
 // Main class for sending IR
 //
 class IRsend
 {
 	public:
-		IRsend () { }
+#if SENDBUF
+		IRsend () : encoding(false), queueing(false) { }
+#else
+		IRsend () : encoding(false) { }
+#endif
 
 		void  custom_delay_usec (unsigned long uSecs);
 		void  enableIROut 		(int khz) ;
+		void  enableIROutHz		(unsigned long hz,  uint8_t duty = IR_DUTY_33) ;
+		unsigned long  carrierHz ( ) ;  // The carrier the timer really gives
 		void  mark        		(unsigned int usec) ;
 		void  space       		(unsigned int usec) ;
 		void  sendRaw     		(const unsigned int buf[],  unsigned int len,  unsigned int hz) ;
+		void  sendRaw_P   		(const unsigned int buf[],  unsigned int len,  unsigned int hz) ;  // buf in PROGMEM
+		void  sendRawTicks_P	(const uint8_t buf[],  unsigned int len,  unsigned int hz) ;       // buf in PROGMEM
+
+		//......................................................................
+		// Codes rendered by encode(), sent one after another
+		void  sendSequence   (const IRframe frames[],  unsigned int count) ;
+
+		// Render any of the sends below into buf (of size entries) instead of
+		//   sending it; false if it does not fit, eg.
+		//   ok = irsend.encode(&frame, buf, 100, &IRsend::sendNEC, 0x20DF10EFUL, 32);
+		// Without C++11, the same is
+		//   irsend.encodeBegin(&frame, buf, 100);  irsend.sendNEC(0x20DF10EFUL, 32);
+		//   ok = irsend.encodeEnd();
+		void  encodeBegin    (IRframe *frame,  unsigned int *buf,  unsigned int size) ;
+		bool  encodeEnd      ( ) ;
+#		if (__cplusplus >= 201103L)
+			template <typename... P,  typename... A>
+			bool  encode (IRframe *frame,  unsigned int *buf,  unsigned int size,  void (IRsend::*send)(P...),  A... args)
+			{
+				encodeBegin(frame, buf, size);
+				(this->*send)(args...);
+				return encodeEnd();
+			}
+#		endif
+
+		//......................................................................
+		// A table driven protocol (proto in PROGMEM); nbits 0 for all its bits
+		void  sendProtocol   (const ir_protocol_t *proto,  unsigned long data,  int nbits = 0,  bool repeat = false) ;
+		bool  encodeProtocol (IRframe *frame,  unsigned int *buf,  unsigned int size,
+		                      const ir_protocol_t *proto,  unsigned long data,  int nbits = 0,  bool repeat = false) ;
+
+		//......................................................................
+		// Several emitters, each gated by a pin, sharing the carrier (IR_GATES)
+#		if IR_GATES
+			void  gatePins       (const uint8_t pins[],  uint8_t count) ;
+			void  selectGates    (uint8_t mask) ;  // Bit n for pins[n]; the sends below use them all
+			bool  sendRawMulti   (const unsigned int *bufs[],  const unsigned int lens[],
+			                      uint8_t count,  unsigned int hz) ;
+#		endif
+
+		//......................................................................
+		// Non-blocking sends: the code is queued and sent by the timer interrupt
+		// They return false if the code does not fit in the queue (SENDBUF)
+		// A code whose carrier is above SEND_INTR_MAX_HZ (IRremoteInt.h) is sent
+		//   blocking, or refused if it is not the first of a sequence
+		// Any other send between queueBegin() and queueEnd() is queued as well,
+		//   eg. queueBegin(); sendSony(0xA90, 12); ok = queueEnd();
+#		if SENDBUF
+			bool  sendRawAsync   (const unsigned int buf[],  unsigned int len,  unsigned int hz) ;
+			bool  sendSequenceAsync (const IRframe frames[],  unsigned int count) ;
+			bool  isSendBusy     ( ) ;
+			void  onSendDone     (void (*callback)(void)) ;  // Called from the ISR after each code
+			void  queueBegin     ( ) ;
+			bool  queueEnd       ( ) ;
+#		endif
 
 		//......................................................................
 #		if SEND_RC5
@@ -291,6 +798,9 @@ class IRsend
 		//......................................................................
 #		if SEND_NEC
 			void  sendNEC        (unsigned long data,  int nbits) ;
+#			if SENDBUF
+				bool  sendNECAsync   (unsigned long data,  int nbits) ;
+#			endif
 #		endif
 		//......................................................................
 #		if SEND_SONY
@@ -348,14 +858,43 @@ class IRsend
 		//......................................................................
 #		if SEND_PRONTO
 			void  sendPronto     (char* code,  bool repeat,  bool fallback) ;
+			bool  compilePronto  (const char *code,  ProntoCode *pronto,  unsigned int *buf,  unsigned int size) ;
+			bool  compilePronto_P(PGM_P code,  ProntoCode *pronto,  unsigned int *buf,  unsigned int size) ;
+			void  sendPronto     (const ProntoCode *pronto,  bool repeat,  bool fallback) ;
+#			if SENDBUF
+				bool  sendProntoAsync (const ProntoCode *pronto,  bool repeat,  bool fallback) ;
+#			endif
 #		endif
 		//......................................................................
 #		if SEND_RSTEP
-			void  sendRstep      (char* code,  bool repeat,  bool fallback) ;
+			// address is the 9 bits decodeRstep() gives: Customer ID, Address,
+			//   Frametype and Battery; khz is 38 or 56
+			void  sendRstep      (unsigned int address,  unsigned long data,  int nbits,  int khz = 38) ;
 #		endif
 		//......................................................................
 #		if SEND_LEGO_PF
 			void  sendLegoPowerFunctions (uint16_t data, bool repeat = true) ;
+			// Several channels at once, without blocking for the repeats
+			void  scheduleLegoPowerFunctions (uint16_t data) ;
+			bool  runLegoPowerFunctions ( ) ;  // Call often; false when all is sent
+#		endif
+
+	private:
+		bool           encoding;       // true -> enableIROut(), mark() & space() render to encode_frame
+		bool           encode_ok;      // false -> the code being rendered did not fit
+		IRframe       *encode_frame;
+		unsigned int   encode_size;    // Entries of room in encode_frame->data
+		unsigned long  encode_period;  // uS from the start of one frame to the next, if the send sets it
+
+		void  encodeAdd   (bool mark,  unsigned int time) ;
+
+#		if SENDBUF
+			bool         queueing;       // true -> enableIROut(), mark() & space() add to the send queue
+			bool         queue_ok;       // false -> the code being queued did not fit
+			uint8_t      queue_end;      // Next free entry for the code being queued
+			ircarrier_t  queue_carrier;  // Carrier of the code being queued
+
+			void  queueAdd   (unsigned int entry) ;
 #		endif
 } ;
 
@@ -28,6 +28,12 @@
 #	endif
 #endif
 
+//------------------------------------------------------------------------------
+// All board specific stuff has been moved to its own file, included here.
+// Before irparams_t, whose layout depends on it (IR_FAST_PINS)
+//
+#include "boarddefs.h"
+
 //------------------------------------------------------------------------------
 // This handles definition and access to global variables
 //
@@ -40,23 +46,143 @@
 //------------------------------------------------------------------------------
 // Information for the Interrupt Service Routine
 //
-#define RAWBUF  101  // Maximum length of raw duration buffer
+// Maximum length of raw duration buffer
+// Long air conditioner frames (Daikin, Mitsubishi & Panasonic AC...) need
+//   from 230 to over 400 entries; either build with a bigger RAWBUF, or pass
+//   a buffer of your own to IRrecv::useBuffer() for the odd long capture
+#ifndef RAWBUF
+#	define RAWBUF  101
+#endif
+
+// Count of entries in a frame slot
+#if (RAWBUF > 255)
+	typedef  unsigned int  rawlen_t;
+#else
+	typedef  uint8_t       rawlen_t;
+#endif
+
+// Number of frames the ISR can hold while the sketch is busy decoding
+// With 1, as before, the ISR stops after each frame until resume() is called
+// Each extra frame costs RAWBUF*2 + 2 bytes of RAM
+//   (RAWBUF + RAWBUF_LONGS*2 + 3 with IR_COMPACT_RAWBUF)
+#ifndef RAWBUF_FRAMES
+#	define RAWBUF_FRAMES  1
+#endif
+
+// Noise filtering while a frame is recorded
+// IR_GLITCH_TICKS: a mark or space of this many ticks or fewer (a spike from
+//   sunlight or a fluorescent lamp) is not recorded as an interval of its own,
+//   but merged with the ones either side of it.  It must be shorter than any
+//   real mark or space: 1 or 2 at the default 50uS tick.  0 turns it off
+// IR_MIN_ENTRIES: a frame of fewer entries (the gap counts as one) can be no
+//   code at all, so the ISR drops it rather than queue it for decode()
+#ifndef IR_GLITCH_TICKS
+#	define IR_GLITCH_TICKS  0
+#endif
+#ifndef IR_MIN_ENTRIES
+#	define IR_MIN_ENTRIES   4  // An NEC repeat: gap, mark, space, mark
+#endif
+
+// Low power receiving (IRrecv::lowPower()): after this long with no IR, the
+//   timer is stopped until the next edge.  Keep it longer than any gap a
+//   decoder uses to spot a repeat (Sony & Sanyo: under 40mS), and at least _GAP
+#ifndef IR_SLEEP_USECS
+#	define IR_SLEEP_USECS  100000
+#endif
+
+// Set IR_STATS to 1 to count what the ISRs and decode() cost; see IRrecv::stats()
+// With it 0 (the default) none of the counting is compiled in
+#ifndef IR_STATS
+#	define IR_STATS  0
+#endif
+
+#if IR_STATS
+// What the ISR has seen of one receiver; IRrecv::stats() hands them out
+typedef
+	struct {
+		unsigned long  count;      // Interrupts
+		unsigned long  min;        // Cycles the quickest took
+		unsigned long  max;        // ... and the slowest
+		unsigned long  avg16;      // Running average, in 1/16ths of a cycle
+		unsigned long  frames;     // Frames recorded
+		unsigned long  overflows;  // Frames too long for the buffer
+		unsigned long  glitches;   // Spikes merged away (IR_GLITCH_TICKS)
+		unsigned long  runts;      // Frames dropped as too short (IR_MIN_ENTRIES)
+	}
+irisrstats_t;
+#endif
+
+// One recorded duration (see IR_COMPACT_RAWBUF in IRremote.h)
+#ifdef IR_COMPACT_RAWBUF
+#	define RAWBUF_ESCAPE  0xF8  // 0xF8..0xFF index the side table; up to 247 ticks fit
+
+// Long durations each frame can hold; after that they are clipped
+#	ifndef RAWBUF_LONGS
+#		define RAWBUF_LONGS  4
+#	endif
+#	if (RAWBUF_LONGS > 0x100 - RAWBUF_ESCAPE)
+#		error "RAWBUF_LONGS is too big for the escape codes"
+#	endif
+
+	typedef  uint8_t       rawentry_t;
+#else
+	typedef  unsigned int  rawentry_t;
+#endif
 
 typedef
 	struct {
 		// The fields are ordered to reduce memory over caused by struct-padding
-		uint8_t       rcvstate;        // State Machine state
-		uint8_t       recvpin;         // Pin connected to IR data from detector
-		uint8_t       blinkpin;
-		uint8_t       blinkflag;       // true -> enable blinking of pin on IR processing
-		uint8_t       rawlen;          // counter of entries in rawbuf
-		unsigned int  timer;           // State timer, counts 50uS ticks.
-		unsigned int  rawbuf[RAWBUF];  // raw data
-		uint8_t       overflow;        // Raw buffer overflow occurred
-		bool          inverted_input;  // Input pin is inverted.
+		uint8_t                 rcvstate;        // State Machine state
+		uint8_t                 recvpin;         // Pin connected to IR data from detector
+		uint8_t                 blinkpin;
+		uint8_t                 blinkflag;       // true -> enable blinking of pin on IR processing
+		unsigned int            rawlen;          // counter of entries in rawbuf (which may be the caller's)
+		unsigned int            rawsize;         // Size of rawbuf: RAWBUF, or the caller's buffer
+		bool                    userbuf;         // rawbuf is the caller's buffer, not a slot
+		unsigned int            timer;           // State timer, counts USECPERTICK ticks.
+		volatile rawentry_t    *rawbuf;          // raw data; the frame slot being recorded
+		uint8_t                 overflow;        // Raw buffer overflow occurred
+		bool                    inverted_input;  // Input pin is inverted.
+		bool                    edgemode;        // true -> edge interrupts, false -> USECPERTICK timer
+		unsigned long           lastedge;        // micros() of the last recorded edge (edge mode)
+		bool                    lowpower;        // true -> stop the timer while idle (IRrecv::lowPower())
+		bool                    asleep;          // Timer stopped; waiting on the pin interrupt
+		bool                    woken;           // First mark since waking: time it from lastedge
+		unsigned int            wakeusecs;       // How long the MCU takes to wake from sleep
+#ifdef IR_FAST_PINS
+		volatile uint8_t       *recvreg;         // Input register of recvpin
+		volatile uint8_t       *blinkreg;        // Output register of blinkpin
+		uint8_t                 recvmask;        // Bit of recvpin in recvreg
+		uint8_t                 blinkmask;       // Bit of blinkpin in blinkreg
+#endif
+		bool                    echomask;        // true -> ignore input while we are sending (edge mode)
+		unsigned long           early;           // Protocols to decode without waiting for the gap
+
+		// Frame queue: finished frames wait in slots tail..head-1
+		uint8_t                 head;            // Slot being recorded
+		uint8_t                 tail;            // Oldest finished frame
+		uint8_t                 queued;          // Finished frames waiting (not counting head)
+		unsigned int            overruns;        // Frames lost because every slot was full
+		rawlen_t                framelen[RAWBUF_FRAMES];          // rawlen of each finished frame
+		uint8_t                 frameovf[RAWBUF_FRAMES];          // overflow of each finished frame
+		rawentry_t              frames[RAWBUF_FRAMES][RAWBUF];    // The slots
+#ifdef IR_COMPACT_RAWBUF
+		uint8_t                 nlongs;          // Side table entries used by the frame being recorded
+		unsigned int            longs[RAWBUF_FRAMES][RAWBUF_LONGS];  // Long durations of each slot
+#endif
+#if IR_STATS
+		irisrstats_t            stats;
+#endif
 	}
 irparams_t;
 
+// A frame recorded in buf while slot s was the head, as decode_results::rawbuf sees it
+#ifdef IR_COMPACT_RAWBUF
+#	define RAWBUF_VIEW(irp, buf, s)  rawbuf_t((buf), (irp).longs[s])
+#else
+#	define RAWBUF_VIEW(irp, buf, s)  (buf)
+#endif
+
 // ISR State-Machine : Receiver States
 #define STATE_IDLE      2
 #define STATE_MARK      3
@@ -64,10 +190,129 @@ irparams_t;
 #define STATE_STOP      5
 #define STATE_OVERFLOW  6
 
+// Number of IRrecv objects with a state of their own (at most 4)
+// Each costs a copy of irparams_t; further IRrecv objects share the last one
+#ifndef IR_RECEIVERS
+#	define IR_RECEIVERS  1
+#endif
+
+#if (IR_RECEIVERS < 1) || (IR_RECEIVERS > 4)
+#	error "IR_RECEIVERS must be from 1 to 4"
+#endif
+
 // Allow all parts of the code access to the ISR data
 // NB. The data can be changed by the ISR at any time, even mid-function
 // Therefore we declare it as "volatile" to stop the compiler/CPU caching it
-EXTERN  volatile irparams_t  irparams;
+EXTERN  volatile irparams_t  irrecvs[IR_RECEIVERS];
+EXTERN  uint8_t              irreceivers;  // Entries of irrecvs[] given to IRrecv objects
+
+// The first (or only) receiver, by the name it had before there could be more
+static volatile irparams_t &irparams = irrecvs[0];
+
+// The IR LED, for IRrecv::maskEcho()
+EXTERN  volatile bool           irtxon;   // The IR LED is on
+EXTERN  volatile unsigned long  irtxoff;  // micros() when the IR LED last went off; only read while !irtxon
+
+// Called when the frame in irp.rawbuf is complete (see IRremote.cpp)
+void  irFrameDone (volatile irparams_t &irp) ;
+
+// The pin interrupt handlers, one for each receiver (see IRremote.cpp)
+extern void (* const irEdgeISR[IR_RECEIVERS])() ;
+
+// true if a receiver is being sampled by the timer ISR (see IRremote.cpp)
+bool  irTimerBusy ( ) ;
+
+// Called as a mark ends, true if the frame is already complete (see irRecv.cpp)
+bool  irEarlyEnd (volatile irparams_t &irp) ;
+
+//------------------------------------------------------------------------------
+// Queue for the non-blocking sends (see irSend.cpp)
+// Each entry costs 2 bytes of RAM; a 32 bit NEC code takes 72 entries, and
+//   the gap after each code of a sequence (sendSequenceAsync()) 2 more
+// With SENDBUF 0 (the default) the non-blocking sends are left out, and with
+//   them the timer's overflow interrupt, which other timer libraries may want;
+//   set it to 80 or more for one NEC code, 160 or more for a code and a repeat
+//
+#ifndef SENDBUF
+#	define SENDBUF  0
+#endif
+
+#if (SENDBUF > 255)
+#	error "SENDBUF must be 255 or less"
+#endif
+
+// The send interrupt comes once per carrier period; this is the fastest
+//   carrier (in Hz) it is used for, at 200 CPU cycles a period (80kHz at
+//   16MHz), so that it takes no more than a quarter of the CPU.  A code with
+//   a faster carrier (eg. 455kHz B&O) is sent blocking instead.
+#ifndef SEND_INTR_MAX_HZ
+#	define SEND_INTR_MAX_HZ  (SYSCLOCK / 200)
+#endif
+
+#if SENDBUF
+// An entry is the length of a mark (with SEND_MARK set) or of a space, counted
+//   in carrier periods.  A 0 entry is followed by a new carrier (the top,
+//   compare and mode of its ircarrier_t), by SEND_MARK and the emitters to use
+//   (IR_GATES), or by a second 0 at the end of a code
+#define SEND_MARK  0x8000
+
+typedef
+	struct {
+		uint8_t        head;          // Entries up to here are ready; only the sketch moves it
+		uint8_t        tail;          // Next entry to send; only the ISR moves it
+		bool           busy;          // The send interrupt is running
+		unsigned int   left;          // Carrier periods left of the entry being sent
+		void         (*done)(void);   // Called from the ISR at the end of each code
+		unsigned int   buf[SENDBUF];
+	}
+irsend_t;
+
+EXTERN  volatile irsend_t  irsendparams;
+#endif
+
+//------------------------------------------------------------------------------
+// A carrier, as the PWM timer is set for it by IRsend::enableIROutHz()
+// Without TIMER_CONFIG_PWM (boarddefs.h) top is the frequency in kHz, for
+//   TIMER_CONFIG_KHZ(), and compare & mode are not used
+//
+typedef
+	struct {
+		unsigned long  hz;       // The frequency this gives
+		uint16_t       top;      // TOP: the period, in timer clocks
+		uint16_t       compare;  // The compare value: the duty cycle
+		uint8_t        mode;     // The clock select, | IR_PWM_FAST for fast PWM
+	}
+ircarrier_t;
+
+#define IR_PWM_FAST  0x80
+
+//------------------------------------------------------------------------------
+// Several IR emitters sharing the one carrier (see IRsend::gatePins())
+// Each emitter's driver only passes the carrier while its gate pin is high
+//   (an AND gate, or a second transistor in series)
+// Set IR_GATES to the number of emitters, at most 8; 0 leaves this out
+//
+#ifndef IR_GATES
+#	define IR_GATES  0
+#endif
+
+#if (IR_GATES > 8)
+#	error "IR_GATES must be 8 or less"
+#endif
+
+#if IR_GATES
+typedef
+	struct {
+		uint8_t  count;           // Gate pins in use
+		uint8_t  select;          // Emitters the next code goes out on, bit n is pin[n]
+		uint8_t  pin[IR_GATES];
+	}
+irgates_t;
+
+EXTERN  volatile irgates_t  irgates;
+
+void  irGates (uint8_t mask) ;
+#endif
 
 //------------------------------------------------------------------------------
 // Defines for setting and clearing register bits
@@ -92,15 +337,29 @@ EXTERN  volatile irparams_t  irparams;
 
 // Upper and Lower percentage tolerances in measurements
 #define TOLERANCE       25
-#define LTOL            (1.0 - (TOLERANCE/100.))
-#define UTOL            (1.0 + (TOLERANCE/100.))
+#define LTOL            (100 - TOLERANCE)
+#define UTOL            (100 + TOLERANCE)
+
+// How long after our LED goes off the detector may still be seeing it
+#define ECHO_USECS      500
 
 // Minimum gap between IR transmissions
 #define _GAP            5000
 #define GAP_TICKS       (_GAP/USECPERTICK)
+#define SLEEP_TICKS     (IR_SLEEP_USECS/USECPERTICK)
+
+// Tick window for a duration, in integer maths so there is no floating point
+//   on the decode path; with a constant argument they are compile time constants
+#define TICKS_LOW(us)   ((int)(((long)(us) * LTOL) / (100L * USECPERTICK)))
+#define TICKS_HIGH(us)  ((int)(((long)(us) * UTOL) / (100L * USECPERTICK) + 1))
 
-#define TICKS_LOW(us)   ((int)(((us)*LTOL/USECPERTICK)))
-#define TICKS_HIGH(us)  ((int)(((us)*UTOL/USECPERTICK + 1)))
+// Is a measured duration within a window of bit_timing_t (IRremote.h)
+#define IN_WINDOW(ticks, low, high)  (((ticks) >= (low)) && ((ticks) <= (high)))
+
+//------------------------------------------------------------------------------
+// The protocol timings the receiver's quick tests share with the decoders
+//
+#include "irTimings.h"
 
 //------------------------------------------------------------------------------
 // IR detector output is active low
@@ -108,7 +367,4 @@ EXTERN  volatile irparams_t  irparams;
 #define MARK   0
 #define SPACE  1
 
-// All board specific stuff has been moved to its own file, included here.
-#include "boarddefs.h"
-
 #endif
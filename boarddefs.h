@@ -52,6 +52,39 @@
 #	define BLINKLED_OFF()  (PORTB &= B11011111)
 #endif
 
+//------------------------------------------------------------------------------
+// Fast pin access
+// digitalRead() & digitalWrite() are slow, so on AVR the ISRs use the port
+//   register and bitmask of the receive and blink pins, which are looked up
+//   once in enableIRIn()
+//
+#if defined(__AVR__) && !defined(IR_NO_FAST_PINS)
+#	define IR_FAST_PINS
+#endif
+
+//------------------------------------------------------------------------------
+// Low power receiving
+// The pin interrupt mode which wakes a receiver whose timer has been stopped
+//   (see IRrecv::lowPower()).  From power down, an AVR's INTn pins can only
+//   see a level, so there it waits for the detector to pull the pin LOW
+//
+#ifndef IR_WAKE_TRIGGER
+#	if defined(__AVR__)
+#		define IR_WAKE_TRIGGER  LOW
+#	else
+#		define IR_WAKE_TRIGGER  FALLING
+#	endif
+#endif
+
+// The ESP32's attachInterrupt() is not safe to call from an ISR, so there the
+//   wake up interrupt is put on the pin once, by lowPower(), and the ISR just
+//   ignores it while the receiver is awake.  Not on an AVR: while LOW, a level
+//   interrupt would fire over and over for the whole of each mark
+//
+#if defined(ESP32)
+#	define IR_WAKE_ATTACHED
+#endif
+
 //------------------------------------------------------------------------------
 // CPU Frequency
 //
@@ -62,7 +95,49 @@
 #endif
 
 // microseconds per clock interrupt tick
-#define USECPERTICK    50
+// All of the receive timings are worked out from this, so it may be changed
+//   (eg. -DUSECPERTICK=25) for finer timing, or for fewer interrupts.
+// Bear in mind the timer ISR has to fit in one tick: on a 16MHz AVR, 25uS
+//   (400 cycles) is about the limit.  The edge engine has no such limit.
+// The decoders are checked (test/, on the corpus) from 10 to 75uS.  Coarser
+//   than that, rStep's 213uS pulses and RC6's 444uS ones are too few ticks
+//   to tell apart from the next size up (at 100uS an RC6 frame reads as
+//   Sony), and finer, IR_COMPACT_RAWBUF has too few RAWBUF_LONGS.
+#ifndef USECPERTICK
+#	define USECPERTICK  50
+#endif
+
+//------------------------------------------------------------------------------
+// A free running count of CPU cycles, for IR_STATS
+// Where the core has no cycle counter it is worked out from micros(), which on
+//   an AVR moves in steps of 4uS (64 cycles at 16MHz): single readings are
+//   coarse, averages less so.  micros() also costs some 60 cycles a call.
+// The timer ISR is timed from the library timer's own count instead, where
+//   the timer section below has TIMER_TICK_CYCLES() (the AVR timers 1, 2, 3
+//   and 5): to the cycle, or 8 cycles with the /8 prescaler.
+// The ESP32's CCOUNT is read directly, as that is safe in an ISR in IRAM.
+//
+#if defined(ESP32)
+#	define IR_CYCLES()       ({ unsigned long  c;  __asm__ __volatile__ ("rsr %0, ccount" : "=a" (c));  c; })
+#	define IR_CYCLES_INIT()
+#elif defined(__arm__) && defined(CORE_TEENSY) && defined(ARM_DWT_CYCCNT)
+#	define IR_CYCLES()       ((unsigned long)ARM_DWT_CYCCNT)
+#	define IR_CYCLES_INIT()  (ARM_DEMCR |= ARM_DEMCR_TRCENA, ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA)
+#else
+#	define IR_CYCLES()       (micros() * (SYSCLOCK / 1000000UL))
+#	define IR_CYCLES_INIT()
+#endif
+
+//------------------------------------------------------------------------------
+// Attribute for the interrupt handlers, and for every function of ours they
+//   call: the ESP32 needs all of them in IRAM, so they still run while the
+//   flash cache is off (the core's micros(), digitalRead() etc. already are)
+//
+#if defined(ESP32)
+#	define IR_ISR_ATTR  IRAM_ATTR
+#else
+#	define IR_ISR_ATTR
+#endif
 
 //------------------------------------------------------------------------------
 // Define which timer to use
@@ -156,6 +231,12 @@
 
 //------------------------------------------------------------------------------
 // Defines for Timer
+//
+// TIMER_SEND_INTR_NAME, where defined, is an interrupt once every period of the
+//   carrier, used by the non-blocking sends.  Without it they block as usual.
+// TIMER_CONFIG_PWM, where defined, sets the carrier with any prescaler, in
+//   phase-correct or fast PWM, so enableIROutHz() can pick the nearest match.
+//   Without it the carrier is TIMER_CONFIG_KHZ() of the nearest kHz.
 
 //---------------------------------------------------------
 // Timer2 (8 bits)
@@ -168,6 +249,9 @@
 #define TIMER_ENABLE_INTR   (TIMSK2 = _BV(OCIE2A))
 #define TIMER_DISABLE_INTR  (TIMSK2 = 0)
 #define TIMER_INTR_NAME     TIMER2_COMPA_vect
+#define TIMER_ENABLE_SEND_INTR   (TIMSK2 = _BV(TOIE2))
+#define TIMER_DISABLE_SEND_INTR  (TIMSK2 = 0)
+#define TIMER_SEND_INTR_NAME     TIMER2_OVF_vect
 
 #define TIMER_CONFIG_KHZ(val) ({ \
 	const uint8_t pwmval = SYSCLOCK / 2000 / (val); \
@@ -177,6 +261,17 @@
 	OCR2B                = pwmval / 3; \
 })
 
+// For enableIROutHz(): the prescalers in clock select order (CS2 = 1 onwards),
+//   the largest TOP, and the timer set for a clock select, TOP & compare value
+#define TIMER_PWM_PRESCALERS  { 1, 8, 32, 64, 128, 256, 1024 }
+#define TIMER_PWM_TOP         255
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+	TCCR2A = _BV(WGM20) | ((fast) ? _BV(WGM21) : 0); \
+	TCCR2B = _BV(WGM22) | (cs); \
+	OCR2A  = (top); \
+	OCR2B  = (compare); \
+})
+
 #define TIMER_COUNT_TOP  (SYSCLOCK * USECPERTICK / 1000000)
 
 //-----------------
@@ -187,6 +282,8 @@
 		OCR2A  = TIMER_COUNT_TOP; \
 		TCNT2  = 0; \
 	})
+#	define TIMER_TICK_CYCLES()  ((unsigned int)TCNT2)
+#	define TIMER_TICK_PERIOD()  (OCR2A + 1U)
 #else
 #	define TIMER_CONFIG_NORMAL() ({ \
 		TCCR2A = _BV(WGM21); \
@@ -194,6 +291,8 @@
 		OCR2A  = TIMER_COUNT_TOP / 8; \
 		TCNT2  = 0; \
 	})
+#	define TIMER_TICK_CYCLES()  (TCNT2 * 8U)
+#	define TIMER_TICK_PERIOD()  ((OCR2A + 1U) * 8)
 #endif
 
 //-----------------
@@ -226,13 +325,18 @@
 || defined(__AVR_ATmega64__) || defined(__AVR_ATmega128__)
 #	define TIMER_ENABLE_INTR   (TIMSK |= _BV(OCIE1A))
 #	define TIMER_DISABLE_INTR  (TIMSK &= ~_BV(OCIE1A))
+#	define TIMER_ENABLE_SEND_INTR   (TIMSK |= _BV(TOIE1))
+#	define TIMER_DISABLE_SEND_INTR  (TIMSK &= ~_BV(TOIE1))
 #else
 #	define TIMER_ENABLE_INTR   (TIMSK1 = _BV(OCIE1A))
 #	define TIMER_DISABLE_INTR  (TIMSK1 = 0)
+#	define TIMER_ENABLE_SEND_INTR   (TIMSK1 = _BV(TOIE1))
+#	define TIMER_DISABLE_SEND_INTR  (TIMSK1 = 0)
 #endif
 
 //-----------------
 #define TIMER_INTR_NAME       TIMER1_COMPA_vect
+#define TIMER_SEND_INTR_NAME  TIMER1_OVF_vect
 
 #define TIMER_CONFIG_KHZ(val) ({ \
 	const uint16_t pwmval = SYSCLOCK / 2000 / (val); \
@@ -242,12 +346,24 @@
 	OCR1A                 = pwmval / 3; \
 })
 
+// For enableIROutHz(), as for Timer2
+#define TIMER_PWM_PRESCALERS  { 1, 8, 64, 256, 1024 }
+#define TIMER_PWM_TOP         0xFFFF
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+	TCCR1A = _BV(WGM11); \
+	TCCR1B = _BV(WGM13) | ((fast) ? _BV(WGM12) : 0) | (cs); \
+	ICR1   = (top); \
+	OCR1A  = (compare); \
+})
+
 #define TIMER_CONFIG_NORMAL() ({ \
 	TCCR1A = 0; \
 	TCCR1B = _BV(WGM12) | _BV(CS10); \
 	OCR1A  = SYSCLOCK * USECPERTICK / 1000000; \
 	TCNT1  = 0; \
 })
+#define TIMER_TICK_CYCLES()  ((unsigned int)TCNT1)
+#define TIMER_TICK_PERIOD()  (OCR1A + 1U)
 
 //-----------------
 #if defined(CORE_OC1A_PIN)
@@ -279,6 +395,9 @@
 #define TIMER_ENABLE_INTR    (TIMSK3 = _BV(OCIE3A))
 #define TIMER_DISABLE_INTR   (TIMSK3 = 0)
 #define TIMER_INTR_NAME      TIMER3_COMPA_vect
+#define TIMER_ENABLE_SEND_INTR   (TIMSK3 = _BV(TOIE3))
+#define TIMER_DISABLE_SEND_INTR  (TIMSK3 = 0)
+#define TIMER_SEND_INTR_NAME     TIMER3_OVF_vect
 
 #define TIMER_CONFIG_KHZ(val) ({ \
   const uint16_t pwmval = SYSCLOCK / 2000 / (val); \
@@ -288,12 +407,24 @@
   OCR3A = pwmval / 3; \
 })
 
+// For enableIROutHz(), as for Timer2
+#define TIMER_PWM_PRESCALERS  { 1, 8, 64, 256, 1024 }
+#define TIMER_PWM_TOP         0xFFFF
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+  TCCR3A = _BV(WGM31); \
+  TCCR3B = _BV(WGM33) | ((fast) ? _BV(WGM32) : 0) | (cs); \
+  ICR3 = (top); \
+  OCR3A = (compare); \
+})
+
 #define TIMER_CONFIG_NORMAL() ({ \
   TCCR3A = 0; \
   TCCR3B = _BV(WGM32) | _BV(CS30); \
   OCR3A = SYSCLOCK * USECPERTICK / 1000000; \
   TCNT3 = 0; \
 })
+#define TIMER_TICK_CYCLES()  ((unsigned int)TCNT3)
+#define TIMER_TICK_PERIOD()  (OCR3A + 1U)
 
 //-----------------
 #if defined(CORE_OC3A_PIN)
@@ -374,6 +505,9 @@
 #define TIMER_ENABLE_INTR   (TIMSK4 = _BV(OCIE4A))
 #define TIMER_DISABLE_INTR  (TIMSK4 = 0)
 #define TIMER_INTR_NAME     TIMER4_COMPA_vect
+#define TIMER_ENABLE_SEND_INTR   (TIMSK4 = _BV(TOIE4))
+#define TIMER_DISABLE_SEND_INTR  (TIMSK4 = 0)
+#define TIMER_SEND_INTR_NAME     TIMER4_OVF_vect
 
 #define TIMER_CONFIG_KHZ(val) ({ \
   const uint16_t pwmval = SYSCLOCK / 2000 / (val); \
@@ -383,6 +517,16 @@
   OCR4A = pwmval / 3; \
 })
 
+// For enableIROutHz(), as for Timer2
+#define TIMER_PWM_PRESCALERS  { 1, 8, 64, 256, 1024 }
+#define TIMER_PWM_TOP         0xFFFF
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+  TCCR4A = _BV(WGM41); \
+  TCCR4B = _BV(WGM43) | ((fast) ? _BV(WGM42) : 0) | (cs); \
+  ICR4 = (top); \
+  OCR4A = (compare); \
+})
+
 #define TIMER_CONFIG_NORMAL() ({ \
   TCCR4A = 0; \
   TCCR4B = _BV(WGM42) | _BV(CS40); \
@@ -410,6 +554,9 @@
 #define TIMER_ENABLE_INTR   (TIMSK5 = _BV(OCIE5A))
 #define TIMER_DISABLE_INTR  (TIMSK5 = 0)
 #define TIMER_INTR_NAME     TIMER5_COMPA_vect
+#define TIMER_ENABLE_SEND_INTR   (TIMSK5 = _BV(TOIE5))
+#define TIMER_DISABLE_SEND_INTR  (TIMSK5 = 0)
+#define TIMER_SEND_INTR_NAME     TIMER5_OVF_vect
 
 #define TIMER_CONFIG_KHZ(val) ({ \
   const uint16_t pwmval = SYSCLOCK / 2000 / (val); \
@@ -419,12 +566,24 @@
   OCR5A = pwmval / 3; \
 })
 
+// For enableIROutHz(), as for Timer2
+#define TIMER_PWM_PRESCALERS  { 1, 8, 64, 256, 1024 }
+#define TIMER_PWM_TOP         0xFFFF
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+  TCCR5A = _BV(WGM51); \
+  TCCR5B = _BV(WGM53) | ((fast) ? _BV(WGM52) : 0) | (cs); \
+  ICR5 = (top); \
+  OCR5A = (compare); \
+})
+
 #define TIMER_CONFIG_NORMAL() ({ \
   TCCR5A = 0; \
   TCCR5B = _BV(WGM52) | _BV(CS50); \
   OCR5A = SYSCLOCK * USECPERTICK / 1000000; \
   TCNT5 = 0; \
 })
+#define TIMER_TICK_CYCLES()  ((unsigned int)TCNT5)
+#define TIMER_TICK_PERIOD()  (OCR5A + 1U)
 
 //-----------------
 #if defined(CORE_OC5A_PIN)
@@ -468,6 +627,9 @@
 #if F_BUS < 8000000
 #error IRremote requires at least 8 MHz on Teensy 3.x
 #endif
+#if USECPERTICK < 32
+#error IRremote needs a USECPERTICK of at least 32 on Teensy 3.x
+#endif
 
 //-----------------
 #define TIMER_CONFIG_KHZ(val) ({ 	 \
@@ -492,7 +654,7 @@
 	CMT_CMD1   = 0;               \
 	CMT_CMD2   = 30;              \
 	CMT_CMD3   = 0;               \
-	CMT_CMD4   = (F_BUS / 160000 + CMT_PPS_DIV / 2) / CMT_PPS_DIV - 31; \
+	CMT_CMD4   = ((F_BUS / 8000) * USECPERTICK / 1000 + CMT_PPS_DIV / 2) / CMT_PPS_DIV - 31; \
 	CMT_OC     = 0;               \
 	CMT_MSC    = 0x03;            \
 })
@@ -523,7 +685,7 @@
 	SIM_SCGC6 |= SIM_SCGC6_TPM1;                 \
 	FTM1_SC = 0;                                 \
 	FTM1_CNT = 0;                                \
-	FTM1_MOD = (F_PLL/40000) - 1;                \
+	FTM1_MOD = ((F_PLL/2000) * USECPERTICK / 1000) - 1; \
 	FTM1_C0V = 0;                                \
 	FTM1_SC = FTM_SC_CLKS(1) | FTM_SC_PS(0) | FTM_SC_TOF | FTM_SC_TOIE; \
 })
@@ -544,6 +706,15 @@
   OCR0A = pwmval; \
   OCR0B = pwmval / 3; \
 })
+// For enableIROutHz(), as for Timer2
+#define TIMER_PWM_PRESCALERS  { 1, 8, 64, 256, 1024 }
+#define TIMER_PWM_TOP         255
+#define TIMER_CONFIG_PWM(cs, fast, top, compare) ({ \
+  TCCR0A = _BV(WGM00) | ((fast) ? _BV(WGM01) : 0); \
+  TCCR0B = _BV(WGM02) | (cs); \
+  OCR0A = (top); \
+  OCR0B = (compare); \
+})
 #define TIMER_COUNT_TOP      (SYSCLOCK * USECPERTICK / 1000000)
 #if (TIMER_COUNT_TOP < 256)
 #define TIMER_CONFIG_NORMAL() ({ \
@@ -0,0 +1,209 @@
+/*
+ * IRremote: IRbenchmark - how fast, and how reliably, decode() works
+ * No IR hardware is needed: frames of each protocol are made up, with as much
+ * timing jitter and noise as you like, and handed straight to decode().
+ *
+ * For each protocol it prints the frames decoded correctly, and the mean and
+ * worst time decode() took, in uS.  Run it again after changing the library,
+ * or its options, to see what the change costs.
+ * test/bench.cpp is the same benchmark for the PC ("make -C test bench"),
+ * which also fails if a protocol decodes fewer frames than it used to.
+ */
+
+#include <IRremote.h>
+#include <IRremoteInt.h>
+
+#define FRAMES   200   // Frames of each protocol
+#define JITTER    10   // Each mark & space is off by up to this many percent
+#define NOISE      5   // Out of 100 frames, how many have a glitch in a mark
+
+IRrecv irrecv(0);  // Never enabled: the frames go straight into irparams
+
+decode_results results;
+
+// The shape of each protocol's frames
+#define PDIST   0  // Pulse distance: bits are the space after each mark
+#define PWIDTH  1  // Pulse width: bits are the length of the mark (Sony)
+#define BIRC5   2  // Bi-phase (RC5)
+#define BIRC6   3  // Bi-phase with a header and a double width trailer bit (RC6)
+#define NOISY   4  // Random marks & spaces, which should come out UNKNOWN
+
+struct proto {
+  const char    *name;
+  int            type;
+  uint8_t        shape;
+  unsigned int   hdrMark, hdrSpace, bitMark, one, zero;
+  uint8_t        bits;
+  unsigned long  fixed;  // Value to send, for protocols with a check; 0 for random
+};
+
+const proto protos[] = {
+  { "NEC",       NEC,       PDIST,  9000, 4500,  560, 1690,  560, 32, 0 },
+  { "Samsung",   SAMSUNG,   PDIST,  5000, 5000,  560, 1600,  560, 32, 0 },
+  { "JVC",       JVC,       PDIST,  8000, 4000,  600, 1600,  550, 16, 0 },
+  { "LG",        LG,        PDIST,  8000, 4000,  600, 1600,  550, 28, 0x8800347 },
+  { "Denon",     DENON,     PDIST,   300,  750,  300, 1800,  750, 14, 0 },
+  { "Panasonic", PANASONIC, PDIST,  3502, 1750,  502, 1244,  400, 48, 0 },
+  { "Sony",      SONY,      PWIDTH, 2400,  600,  600, 1200,  600, 12, 0 },
+  { "RC5",       RC5,       BIRC5,     0,    0,  889,    0,    0, 12, 0 },
+  { "RC6",       RC6,       BIRC6,  2666,  889,  444,    0,    0, 20, 0 },
+  { "Unknown",   UNKNOWN,   NOISY,     0,    0,    0,    0,    0, 40, 0 },
+};
+
+//------------------------------------------------------------------------------
+// The frame being made, in irparams as if the receiver had just recorded it
+
+bool lastMark;
+
+void put(unsigned int ticks) {
+#ifdef IR_COMPACT_RAWBUF
+  if (ticks >= RAWBUF_ESCAPE) ticks = RAWBUF_ESCAPE - 1;
+#endif
+  irparams.rawbuf[irparams.rawlen++] = ticks;
+}
+
+// A mark or space of us microseconds, give or take JITTER percent
+void add(bool mark, unsigned int us) {
+  if (irparams.rawlen >= RAWBUF) return;
+  long t = (long)us * (100 + random(-JITTER, JITTER + 1)) / 100;
+  t += mark ? MARK_EXCESS : -MARK_EXCESS;
+  if (t < USECPERTICK) t = USECPERTICK;
+  if (mark == lastMark && irparams.rawlen > 1) {
+    irparams.rawbuf[irparams.rawlen - 1] += t / USECPERTICK;  // Bi-phase: same level again
+  } else {
+    put(t / USECPERTICK);
+  }
+  lastMark = mark;
+}
+
+// A frame of protocol p carrying value; returns the value decode() should find
+unsigned long frame(const proto &p) {
+  unsigned long value = p.fixed ? p.fixed : ((unsigned long)random(0x10000) << 16) | random(0x10000);
+  if (p.bits < 32) value &= (1UL << p.bits) - 1;
+
+  // The gap before the frame, long enough not to look like a repeat
+  irparams.rawlen = 1;
+#ifdef IR_COMPACT_RAWBUF
+  irparams.rawbuf[0] = RAWBUF_ESCAPE;  // Too long for an entry: in the side table
+  irparams.longs[irparams.head][0] = 100000 / USECPERTICK;
+  irparams.nlongs = 1;
+#else
+  irparams.rawbuf[0] = 100000 / USECPERTICK;
+#endif
+  lastMark = false;
+
+  switch (p.shape) {
+    case PDIST:
+      add(true, p.hdrMark);
+      add(false, p.hdrSpace);
+      for (int i = p.bits - 1; i >= 0; i--) {
+        // Panasonic sends a fixed 16 bit address before its 32 bits of data
+        bool bit = (i < 32) ? ((value >> i) & 1) : ((0x4004 >> (i - 32)) & 1);
+        add(true, p.bitMark);
+        add(false, bit ? p.one : p.zero);
+      }
+      add(true, p.bitMark);
+      break;
+
+    case PWIDTH:
+      add(true, p.hdrMark);
+      for (int i = p.bits - 1; i >= 0; i--) {
+        add(false, p.hdrSpace);
+        add(true, ((value >> i) & 1) ? p.one : p.zero);
+      }
+      break;
+
+    case BIRC5:
+      add(true, p.bitMark);
+      add(false, p.bitMark);
+      add(true, p.bitMark);
+      for (int i = p.bits - 1; i >= 0; i--) {
+        bool bit = (value >> i) & 1;
+        add(!bit, p.bitMark);
+        add(bit, p.bitMark);
+      }
+      break;
+
+    case BIRC6:
+      add(true, p.hdrMark);
+      add(false, p.hdrSpace);
+      add(true, p.bitMark);
+      add(false, p.bitMark);
+      for (int i = p.bits - 1; i >= 0; i--) {
+        bool bit = (value >> i) & 1;
+        unsigned int t = (i == p.bits - 4) ? 2 * p.bitMark : p.bitMark;
+        add(bit, t);
+        add(!bit, t);
+      }
+      break;
+
+    case NOISY:
+      for (int i = 0; i < p.bits; i++) add(!(i & 1), random(200, 3000));
+      break;
+  }
+
+  if (!lastMark) irparams.rawlen--;  // A frame ends with its last mark
+
+  // A glitch: a mark broken by a one tick space
+  if (random(100) < NOISE && irparams.rawlen + 2 <= RAWBUF) {
+    int at = 1 + 2 * random((irparams.rawlen - 1) / 2);  // A mark
+    unsigned int ticks = irparams.rawbuf[at];
+    if (ticks > 2) {
+      for (int i = irparams.rawlen - 1; i > at; i--) irparams.rawbuf[i + 2] = irparams.rawbuf[i];
+      irparams.rawbuf[at] = ticks / 2;
+      irparams.rawbuf[at + 1] = 1;
+      irparams.rawbuf[at + 2] = ticks - ticks / 2 - 1;
+      irparams.rawlen += 2;
+    }
+  }
+
+  irparams.rcvstate = STATE_STOP;
+  return value;
+}
+
+//------------------------------------------------------------------------------
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println("protocol   decoded  mean uS  worst uS");
+
+  unsigned long allTime = 0;
+  unsigned int  allFrames = 0;
+
+  for (unsigned int n = 0; n < sizeof(protos) / sizeof(protos[0]); n++) {
+    const proto &p = protos[n];
+    unsigned int  good  = 0;
+    unsigned long total = 0;
+    unsigned long worst = 0;
+
+    for (int f = 0; f < FRAMES; f++) {
+      unsigned long value = frame(p);
+
+      unsigned long start = micros();
+      bool decoded = irrecv.decode(&results);
+      unsigned long took = micros() - start;
+
+      total += took;
+      if (took > worst) worst = took;
+      if (decoded && results.decode_type == p.type
+          && (p.type == UNKNOWN || (uint32_t)results.value == (uint32_t)value)) good++;
+      irrecv.resume();
+    }
+    allTime += total;
+    allFrames += FRAMES;
+
+    Serial.print(p.name);
+    for (int pad = strlen(p.name); pad < 11; pad++) Serial.print(' ');
+    Serial.print(good * 100UL / FRAMES);
+    Serial.print("%\t ");
+    Serial.print(total / FRAMES);
+    Serial.print("\t  ");
+    Serial.println(worst);
+  }
+
+  Serial.print("All frames: mean uS ");
+  Serial.println(allTime / allFrames);
+}
+
+void loop() {
+}
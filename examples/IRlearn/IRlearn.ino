@@ -0,0 +1,63 @@
+/*
+ * IRlearn: learn the buttons of any remote, and tell them apart afterwards
+ * An IR detector/demodulator must be connected to the input RECV_PIN.
+ *
+ * Send a button number (0..9) over serial, then press that button on the
+ * remote; the library of learned codes is kept in EEPROM.  Any other code
+ * received is looked up, and the button number printed.
+ */
+
+#include <IRremote.h>
+#include <EEPROM.h>
+
+int RECV_PIN = 11;
+
+IRrecv irrecv(RECV_PIN);
+
+decode_results results;
+
+uint8_t  library[512];   // Learned codes, as in EEPROM
+int      learning = -1;  // The button being learned, if any
+
+// Read a byte of the library from EEPROM
+uint8_t readEEPROM(unsigned int addr)
+{
+  return EEPROM.read(addr);
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  for (unsigned int i = 0; i < sizeof(library); i++) library[i] = EEPROM.read(i);
+  if (library[0] == 0xFF) library[0] = library[1] = 0; // Blank EEPROM: no codes
+  irrecv.enableIRIn(); // Start the receiver
+}
+
+void loop() {
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c >= '0' && c <= '9') {
+      learning = c - '0';
+      Serial.print("Press button ");
+      Serial.println(learning);
+    }
+  }
+
+  if (irrecv.decode(&results)) {
+    if (learning >= 0) {
+      unsigned int used = irrecv.learn(&results, learning, library, sizeof(library));
+      if (used) {
+        for (unsigned int i = 0; i < used; i++) EEPROM.update(i, library[i]);
+        Serial.println("Learned");
+      } else {
+        Serial.println("No room, or too short");
+      }
+      learning = -1;
+    } else {
+      int button = irrecv.findLearned(&results, readEEPROM);
+      Serial.print("Button ");
+      Serial.println(button); // -1 if not learned
+    }
+    irrecv.resume(); // Receive the next value
+  }
+}
@@ -0,0 +1,52 @@
+/*
+ * IRremote: IRprotocolTable - a protocol the library does not know, from a table
+ * An IR detector/demodulator must be connected to the input RECV_PIN, and an
+ * IR LED to the send pin (3 on an Uno).
+ *
+ * The remote of a (made up) Acme fan sends 24 bits, least significant first,
+ * as pulse distance bits after a header: the timings below are all it takes
+ * for the library to send and decode it.  Send any character over serial to
+ * send a code; codes received are printed.
+ */
+
+#include <IRremote.h>
+
+int RECV_PIN = 11;
+
+IRrecv irrecv(RECV_PIN);
+IRsend irsend;
+
+decode_results results;
+
+const ir_protocol_t ACME_PROTOCOL PROGMEM = IR_PROTOCOL(
+  UNKNOWN, 38, 24, IR_PROTO_LSB_FIRST,
+  3400, 1700,        // Header mark & space
+  430, 1290, 430,    // Bit mark; space for a one and for a zero
+  430,               // Footer mark
+  0, 100000          // No repeat code; a frame every 100mS while held
+);
+
+void setup()
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn(); // Start the receiver
+}
+
+void loop() {
+  if (Serial.available()) {
+    Serial.read();
+    irsend.sendProtocol(&ACME_PROTOCOL, 0x00A1F3);
+    irrecv.enableIRIn(); // Re-enable receiver
+  }
+
+  if (irrecv.decode(&results)) {
+    if (irrecv.decodeProtocol(&results, &ACME_PROTOCOL)) {
+      Serial.print("Acme ");
+      Serial.println(results.value, HEX);
+    } else {
+      Serial.print("Other ");
+      Serial.println(results.value, HEX);
+    }
+    irrecv.resume(); // Receive the next value
+  }
+}
@@ -66,7 +66,7 @@ void  dumpInfo (decode_results *results)
 {
   // Check if the buffer overflowed
   if (results->overflow) {
-    Serial.println("IR code too long. Edit IRremoteInt.h and increase RAWBUF");
+    Serial.println("IR code too long. Build with a bigger RAWBUF, or see IRrecv::useBuffer()");
     return;
   }
 
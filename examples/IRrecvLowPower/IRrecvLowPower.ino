@@ -0,0 +1,64 @@
+/*
+ * IRremote: IRrecvLowPower - sleep between button presses
+ * An IR detector/demodulator must be connected to the input RECV_PIN, which
+ * must have an external interrupt (pin 2 or 3 on an Uno).
+ *
+ * Once there has been no IR for a moment, the receiver stops its 50uS timer
+ * and waits for the first edge of the next code; the sketch then powers the
+ * MCU down completely, and the code wakes it again.  The codes received are
+ * printed as in IRrecvDemo.
+ */
+
+#include <IRremote.h>
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+int RECV_PIN = 2;
+
+// How long the MCU takes to wake up: an Uno (16MHz crystal) takes 16K clocks
+// from power down.  The first mark of a code must be longer than this, which
+// RC5, Denon, Sharp, Whynter, Mitsubishi, Lego PF and rStep marks are not:
+// for those use SLEEP_MODE_STANDBY below with a WAKE_USECS of 0.
+#define WAKE_USECS 1000
+
+IRrecv irrecv(RECV_PIN);
+
+decode_results results;
+
+//+=============================================================================
+// Sleep until the receiver is woken by IR
+//
+void sleepNow()
+{
+#ifdef __AVR__
+  Serial.flush();                    // Power down stops the UART too
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  noInterrupts();
+  if (irrecv.isAsleep()) {           // Not woken since we looked
+    sleep_enable();
+    interrupts();                    // Takes effect after sleep_cpu()
+    sleep_cpu();
+    sleep_disable();
+  }
+  interrupts();
+#endif
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn(); // Start the receiver
+  if (!irrecv.lowPower(true, WAKE_USECS)) {
+    Serial.println("RECV_PIN has no external interrupt");
+  }
+}
+
+void loop() {
+  if (irrecv.decode(&results)) {
+    Serial.println(results.value, HEX);
+    irrecv.resume(); // Receive the next value
+  } else if (irrecv.isAsleep()) {
+    sleepNow();
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ * IRremote: IRrecvStats - what receiving costs on this board
+ * An IR detector/demodulator must be connected to the input RECV_PIN.
+ *
+ * The library must be built with IR_STATS set to 1 (in IRremoteInt.h).
+ * Point some remotes at the receiver; every 10 seconds this prints the CPU
+ * cycles the receive interrupt takes, the frames seen, overflowed and lost,
+ * and the tries, hits and cycles of each decoder.
+ */
+
+#include <IRremote.h>
+
+int RECV_PIN = 11;
+
+IRrecv irrecv(RECV_PIN);
+
+decode_results results;
+
+unsigned long lastReport;
+
+//+=============================================================================
+// Name of a decoder, as counted in irstats_t
+//
+const char *protocol(int type)
+{
+  switch (type) {
+    default:
+    case UNKNOWN:      return "UNKNOWN (hash)";
+    case NEC:          return "NEC";
+    case SONY:         return "SONY";
+    case RC5:          return "RC5";
+    case RC6:          return "RC6";
+    case DISH:         return "DISH";
+    case SHARP:        return "SHARP";
+    case JVC:          return "JVC";
+    case SANYO:        return "SANYO";
+    case MITSUBISHI:   return "MITSUBISHI";
+    case SAMSUNG:      return "SAMSUNG";
+    case LG:           return "LG";
+    case WHYNTER:      return "WHYNTER";
+    case AIWA_RC_T501: return "AIWA_RC_T501";
+    case PANASONIC:    return "PANASONIC";
+    case DENON:        return "Denon";
+    case LEGO_PF:      return "LEGO_PF";
+    case RSTEP:        return "rStep";
+  }
+}
+
+//+=============================================================================
+// Print what the receiver has cost so far
+//
+void report()
+{
+#if IR_STATS
+  irstats_t stats;
+  irrecv.stats(&stats);
+
+  Serial.print(F("Interrupts: "));    Serial.println(stats.isrCount);
+  Serial.print(F("  cycles min "));   Serial.print(stats.isrMin);
+  Serial.print(F(" max "));           Serial.print(stats.isrMax);
+  Serial.print(F(" avg "));           Serial.println(stats.isrAvg);
+  Serial.print(F("Frames: "));        Serial.print(stats.frames);
+  Serial.print(F("  overflowed "));   Serial.print(stats.overflows);
+  Serial.print(F("  dropped "));      Serial.println(stats.dropped);
+  Serial.print(F("Glitches merged: ")); Serial.print(stats.glitches);
+  Serial.print(F("  short frames dropped ")); Serial.println(stats.runts);
+
+  Serial.println(F("Decoder          tries   hits   avg cycles"));
+  for (int i = 0; i < IR_STAT_TYPES; i++) {
+    if (!stats.tries[i]) continue;
+    const char *name = protocol(i - 1);
+    Serial.print(name);
+    for (int pad = strlen(name); pad < 16; pad++) Serial.print(' ');
+    Serial.print(stats.tries[i]);
+    Serial.print('\t');
+    Serial.print(stats.hits[i]);
+    Serial.print('\t');
+    Serial.println(stats.cycles[i] / stats.tries[i]);
+  }
+  Serial.println();
+#else
+  Serial.println(F("Set IR_STATS to 1 in IRremoteInt.h to collect statistics"));
+#endif
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  irrecv.enableIRIn(); // Start the receiver
+}
+
+void loop() {
+  if (irrecv.decode(&results)) {
+    irrecv.resume(); // Receive the next value
+  }
+
+  if (millis() - lastReport >= 10000) {
+    lastReport = millis();
+    report();
+  }
+}
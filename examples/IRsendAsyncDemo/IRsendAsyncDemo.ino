@@ -0,0 +1,49 @@
+/*
+ * IRremote: IRsendAsyncDemo - demonstrates sending IR codes without blocking
+ * An IR LED must be connected to Arduino PWM pin 3.
+ * The sketch blinks the LED on pin 13 the whole time a code is being sent.
+ *
+ * The library must be built with SENDBUF set to 80 or more (in IRremoteInt.h).
+ */
+
+#include <IRremote.h>
+
+#if !SENDBUF
+#error "Set SENDBUF to 80 or more in IRremoteInt.h for the non-blocking sends"
+#endif
+
+IRsend irsend;
+
+volatile int  sent = 0;
+
+// Called from the interrupt handler when each code has been sent
+void  codeSent ( )
+{
+	sent++;
+}
+
+void  setup ( )
+{
+	Serial.begin(9600);
+	pinMode(13, OUTPUT);
+	irsend.onSendDone(codeSent);
+}
+
+void  loop ( )
+{
+	static unsigned long  last = 0;
+
+	// Every 2 seconds, queue a code; sendNECAsync() returns straight away
+	if (millis() - last > 2000) {
+		last = millis();
+		if (!irsend.sendNECAsync(0x20DF10EF, 32))  Serial.println("Send queue full") ;
+	}
+
+	// ...leaving loop() free to get on with other things while it is sent
+	digitalWrite(13, irsend.isSendBusy() && (millis() & 64));
+
+	if (sent) {
+		sent = 0;
+		Serial.println("Code sent");
+	}
+}
@@ -0,0 +1,29 @@
+/*
+ * LegoPowerFunctionsSchedulerDemo: LEGO Power Functions on all four channels
+ * Each channel's message is sent with its five repeats, the channels taking
+ * turns in their own time slots, while loop() carries on.
+ */
+
+#include <IRremote.h>
+
+IRsend irsend;
+
+unsigned long lastRefresh;
+
+void setup() {
+}
+
+void loop() {
+  // Every half second, tell each train to keep going: channel n, blue forward
+  if (millis() - lastRefresh >= 500) {
+    lastRefresh = millis();
+    irsend.scheduleLegoPowerFunctions(0x0197);
+    irsend.scheduleLegoPowerFunctions(0x1197);
+    irsend.scheduleLegoPowerFunctions(0x2197);
+    irsend.scheduleLegoPowerFunctions(0x3197);
+  }
+
+  irsend.runLegoPowerFunctions();
+
+  // ... read sensors, points, signals here
+}
@@ -31,6 +31,7 @@ void runBitStreamEncoderTests() {
   testGetChannelId4(bitStreamEncoder);
   testGetMessageLengthAllHigh(bitStreamEncoder);
   testGetMessageLengthAllLow(bitStreamEncoder);
+  testGetRepeatInterval();
 }
 
 void logTestResult(bool testPassed) {
@@ -191,3 +192,13 @@ void testGetMessageLengthAllLow(LegoPfBitStreamEncoder& bitStreamEncoder) {
   bitStreamEncoder.reset(0x0, false);
   logTestResult(bitStreamEncoder.getMessageLength() == 9104);
 }
+
+void testGetRepeatInterval() {
+  Serial.print("  testGetRepeatInterval           ");
+  bool result = true;
+  result = result && LegoPfBitStreamEncoder::getRepeatInterval(1, 0) == 5L * 16000L;
+  result = result && LegoPfBitStreamEncoder::getRepeatInterval(1, 1) == 5L * 16000L;
+  result = result && LegoPfBitStreamEncoder::getRepeatInterval(1, 2) == 8L * 16000L;
+  result = result && LegoPfBitStreamEncoder::getRepeatInterval(4, 3) == 14L * 16000L;
+  logTestResult(result);
+}
@@ -0,0 +1,223 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//                  L      EEEEE   AAA   RRRR   N   N
+//                  L      E      A   A  R   R  NN  N
+//                  L      EEEE   AAAAA  RRRR   N N N
+//                  L      E      A   A  R  R   N  NN
+//                  LLLLL  EEEEE  A   A  R   R  N   N
+//==============================================================================
+
+// A library of learned codes, to tell which of them (which button) a new
+//   capture is, whatever protocol the remote uses.
+//
+// The library is an "image" of bytes, which may be in RAM, in flash (PROGMEM)
+//   or, through a function which reads a byte, in EEPROM or anywhere else:
+//     [0]      count                         2 bytes, as are all words, LSB first
+//     [2]      count index entries of 9 bytes, sorted by len then hash:
+//                len (1 byte), hash (4), action (2), offset of the ticks (2)
+//     [...]    the ticks of each code: its marks & spaces in USECPERTICK ticks,
+//                255 meaning that or longer
+// IRrecv::learn() adds a capture to an image in RAM, which can then be written
+//   to EEPROM as it is, or printed for a PROGMEM table.
+//
+// IRrecv::findLearned() takes the hash of the capture (whatever decode() made
+//   of it) and looks that, and the length, up in the index; if that fails, it
+//   compares the capture with each of the codes of that length, with the
+//   tolerance of MATCH(), and takes the nearest.
+
+#define LEARNED_ENTRY  9               // Bytes per index entry
+#define LEARNED_LONG   255             // The ticks for anything that long or longer
+
+//+=============================================================================
+// Where an image is, and how to read a byte of it
+//
+typedef
+	struct {
+		const uint8_t  *image;
+		learned_read_t  read;
+		bool            pgm;
+	}
+learned_src_t;
+
+static uint8_t  learnedByte (const learned_src_t &src,  unsigned int addr)
+{
+	if (src.read)  return src.read(addr) ;
+	if (src.pgm)   return pgm_read_byte(&src.image[addr]) ;
+	return src.image[addr];
+}
+
+static unsigned int  learnedWord (const learned_src_t &src,  unsigned int addr)
+{
+	return learnedByte(src, addr) | ((unsigned int)learnedByte(src, addr + 1) << 8);
+}
+
+static unsigned long  learnedLong (const learned_src_t &src,  unsigned int addr)
+{
+	return learnedWord(src, addr) | ((unsigned long)learnedWord(src, addr + 2) << 16);
+}
+
+//+=============================================================================
+// The ticks a capture is stored as
+//
+static uint8_t  learnedTicks (unsigned int ticks)
+{
+	return (ticks > LEARNED_LONG) ? LEARNED_LONG : ticks;
+}
+
+//+=============================================================================
+// How far the capture is from a learned code of the same length, or -1 if any
+//   mark or space is out of the MATCH() tolerance
+//
+static long  learnedDistance (const learned_src_t &src,  unsigned int ticks,
+                              const decode_results *results)
+{
+	long  dist = 0;
+
+	for (int i = 1;  i < results->rawlen;  i++) {
+		unsigned int  want = learnedByte(src, ticks++);
+		unsigned int  got  = learnedTicks(results->rawbuf[i]);
+
+		if (want == LEARNED_LONG) {
+			if (got < (LEARNED_LONG * LTOL) / 100)  return -1 ;
+			continue;
+		}
+		if ((got < (want * LTOL) / 100) || (got > (want * UTOL) / 100 + 1))  return -1 ;
+		dist += (got > want) ? (got - want) : (want - got);
+	}
+	return dist;
+}
+
+//+=============================================================================
+// The hash the index is sorted by
+//
+unsigned long  IRrecv::learnedHash (const decode_results *results)
+{
+	decode_results  copy = *results;
+
+	decodeHash(&copy);
+	return copy.value & 0xFFFFFFFFUL;
+}
+
+//+=============================================================================
+// Look a capture up in an image; returns the action, or -1 if it isn't there
+//
+int  IRrecv::learnedFind (const decode_results *results,  const uint8_t *image,
+                          learned_read_t read,  bool pgm)
+{
+	learned_src_t  src   = { image, read, pgm };
+	unsigned int   count = learnedWord(src, 0);
+	unsigned int   len   = results->rawlen - 1;
+	unsigned long  hash;
+	unsigned int   lo    = 0;
+	unsigned int   hi    = count;
+	unsigned int   first;
+	long           best  = -1;
+	int            action = -1;
+
+	if ((results->rawlen < 6) || (len > 255))  return -1 ;
+	hash = learnedHash(results);
+
+	// The first entry of this length (or longer), and the entry for the hash
+	while (lo < hi) {
+		unsigned int   mid = lo + ((hi - lo) >> 1);
+		unsigned int   at  = 2 + (mid * LEARNED_ENTRY);
+		unsigned int   l   = learnedByte(src, at);
+
+		if ((l < len) || ((l == len) && (learnedLong(src, at + 1) < hash)))  lo = mid + 1 ;
+		else                                                                   hi = mid ;
+	}
+	if (lo < count) {
+		unsigned int  at = 2 + (lo * LEARNED_ENTRY);
+		if ((learnedByte(src, at) == len) && (learnedLong(src, at + 1) == hash)
+		    && (learnedDistance(src, learnedWord(src, at + 7), results) >= 0))
+			return (int)learnedWord(src, at + 5);
+	}
+
+	// A noisy capture: try every code of the same length
+	for (first = lo;  (first > 0) && (learnedByte(src, 2 + ((first - 1) * LEARNED_ENTRY)) == len);  first--) ;
+	for (unsigned int e = first;  e < count;  e++) {
+		unsigned int  at = 2 + (e * LEARNED_ENTRY);
+		long          dist;
+
+		if (learnedByte(src, at) != len)  break ;
+		dist = learnedDistance(src, learnedWord(src, at + 7), results);
+		if ((dist >= 0) && ((best < 0) || (dist < best))) {
+			best   = dist;
+			action = (int)learnedWord(src, at + 5);
+		}
+	}
+	return action;
+}
+
+int  IRrecv::findLearned (const decode_results *results,  const uint8_t *image)
+{
+	return learnedFind(results, image, NULL, false);
+}
+
+int  IRrecv::findLearned_P (const decode_results *results,  const uint8_t *image)
+{
+	return learnedFind(results, image, NULL, true);
+}
+
+int  IRrecv::findLearned (const decode_results *results,  learned_read_t read)
+{
+	return learnedFind(results, NULL, read, false);
+}
+
+//+=============================================================================
+// Add a capture to an image in RAM, of size bytes; an empty image is 2 zeros
+// Returns the bytes now in use, or 0 if the code will not fit (or is too short)
+//
+unsigned int  IRrecv::learn (const decode_results *results,  int action,
+                             uint8_t *image,  unsigned int size)
+{
+	learned_src_t  src   = { image, NULL, false };
+	unsigned int   count = learnedWord(src, 0);
+	unsigned int   len   = results->rawlen - 1;
+	unsigned long  hash;
+	unsigned int   used  = 2 + (count * LEARNED_ENTRY);
+	unsigned int   e;
+
+	if ((results->rawlen < 6) || (len > 255))  return 0 ;
+	hash = learnedHash(results);
+
+	for (e = 0;  e < count;  e++)  used += image[2 + (e * LEARNED_ENTRY)] ;
+	if ((used + LEARNED_ENTRY + len) > size)  return 0 ;
+
+	// Where it goes in the index
+	for (e = 0;  e < count;  e++) {
+		unsigned int  at = 2 + (e * LEARNED_ENTRY);
+		unsigned int  l  = image[at];
+		if ((l > len) || ((l == len) && (learnedLong(src, at + 1) > hash)))  break ;
+	}
+
+	// Make room for the entry, and move every code's ticks along to suit
+	unsigned int  at = 2 + (e * LEARNED_ENTRY);
+	memmove(&image[at + LEARNED_ENTRY], &image[at], used - at);
+	used += LEARNED_ENTRY;
+	for (unsigned int i = 0;  i <= count;  i++) {
+		if (i == e)  continue ;
+		unsigned int  off = 2 + (i * LEARNED_ENTRY) + 7;
+		unsigned int  t   = (image[off] | (image[off + 1] << 8)) + LEARNED_ENTRY;
+		image[off]     = t & 0xFF;
+		image[off + 1] = t >> 8;
+	}
+
+	image[at]     = len;
+	image[at + 1] = hash & 0xFF;
+	image[at + 2] = (hash >> 8) & 0xFF;
+	image[at + 3] = (hash >> 16) & 0xFF;
+	image[at + 4] = (hash >> 24) & 0xFF;
+	image[at + 5] = action & 0xFF;
+	image[at + 6] = (action >> 8) & 0xFF;
+	image[at + 7] = used & 0xFF;
+	image[at + 8] = used >> 8;
+	for (int i = 1;  i < results->rawlen;  i++)  image[used++] = learnedTicks(results->rawbuf[i]) ;
+
+	count++;
+	image[0] = count & 0xFF;
+	image[1] = count >> 8;
+	return used;
+}
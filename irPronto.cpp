@@ -1,29 +1,33 @@
-#define TEST 0
-
-#if TEST
-#	define SEND_PRONTO        1
-#	define PRONTO_ONCE        false
-#	define PRONTO_REPEAT      true
-#	define PRONTO_FALLBACK    true
-#	define PRONTO_NOFALLBACK  false
-#endif
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//             PPPP   RRRR    OOO   N   N  TTTTT   OOO
+//             P   P  R   R  O   O  NN  N    T    O   O
+//             PPPP   RRRR   O   O  N N N    T    O   O
+//             P      R  R   O   O  N  NN    T    O   O
+//             P      R   R   OOO   N   N    T     OOO
+//==============================================================================
+
+// A Pronto "Oscillated (Learned)" code is blocks of 4 hex digits:
+//   0000  <carrier>  <once pairs>  <repeat pairs>  <once code...>  <repeat code...>
+// The carrier word is its period in units of 0.241246uS, and each mark and
+//   space of the codes is a count of carrier periods.
+//
+// Sources:
+//   http://www.remotecentral.com/features/irdisp2.htm
+//   http://www.hifi-remote.com/wiki/index.php?title=Working_With_Pronto_Hex
 
 #if SEND_PRONTO
 
-//******************************************************************************
-#if TEST
-#	include <stdio.h>
-	void  enableIROut (int freq)  { printf("\nFreq = %d KHz\n", freq); }
-	void  mark        (int t)     { printf("+%d," , t); }
-	void  space       (int t)     { printf("-%d, ", t); }
-#else
-#	include "IRremote.h"
-#endif // TEST
+// Carriers outside this range are not worth trying (and would overflow the maths)
+#define PRONTO_MIN_KHZ  15
+#define PRONTO_MAX_KHZ  500
 
 //+=============================================================================
 // Check for a valid hex digit
 //
-bool  ishex (char ch)
+static bool  ishex (char ch)
 {
 	return ( ((ch >= '0') && (ch <= '9')) ||
              ((ch >= 'A') && (ch <= 'F')) ||
@@ -33,140 +37,204 @@ bool  ishex (char ch)
 //+=============================================================================
 // Check for a valid "blank" ... '\0' is a valid "blank"
 //
-bool  isblank (char ch)
+static bool  isgap (char ch)
 {
 	return ((ch == ' ') || (ch == '\t') || (ch == '\0')) ? true : false ;
 }
 
-//+=============================================================================
-// Bypass spaces
-//
-bool  byp (char** pcp)
-{
-	while (isblank(**pcp))  (*pcp)++ ;
-}
-
 //+=============================================================================
 // Hex-to-Byte : Decode a hex digit
 // We assume the character has already been validated
 //
-uint8_t  htob (char ch)
+static uint8_t  htob (char ch)
 {
 	if ((ch >= '0') && (ch <= '9'))  return ch - '0' ;
 	if ((ch >= 'A') && (ch <= 'F'))  return ch - 'A' + 10 ;
 	if ((ch >= 'a') && (ch <= 'f'))  return ch - 'a' + 10 ;
+	return 0;
 }
 
 //+=============================================================================
-// Hex-to-Word : Decode a block of 4 hex digits
-// We assume the string has already been validated
-//   and the pointer being passed points at the start of a block of 4 hex digits
+// Read a character of the string, which may be in RAM or in flash (PROGMEM)
 //
-uint16_t  htow (char* cp)
+static inline char  prontoChar (const char *cp,  bool pgm)
 {
-	return ( (htob(cp[0]) << 12) | (htob(cp[1]) <<  8) |
-             (htob(cp[2]) <<  4) | (htob(cp[3])      )  ) ;
+	return pgm ? (char)pgm_read_byte(cp) : *cp ;
 }
 
 //+=============================================================================
+// Read the next block of 4 hex digits in to word, and step past it
+// Returns false at the end of the string, or if the block is not valid
 //
-bool sendPronto (char* s,  bool repeat,  bool fallback)
+static bool  prontoWord (const char **pcp,  bool pgm,  uint16_t *word)
 {
-	int       i;
-	int       len;
-	int       skip;
-	char*     cp;
-	uint16_t  freq;  // Frequency in KHz
-	uint8_t   usec;  // pronto uSec/tick
-	uint8_t   once;
-	uint8_t   rpt;
-
-	// Validate the string
-	for (cp = s;  *cp;  cp += 4) {
-		byp(&cp);
-		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
-		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) )  return false ;
+	const char  *cp = *pcp;
+	char         ch;
+
+	while (((ch = prontoChar(cp, pgm)) != '\0') && isgap(ch))  cp++ ;
+
+	*word = 0;
+	for (int i = 0;  i < 4;  i++, cp++) {
+		ch = prontoChar(cp, pgm);
+		if (!ishex(ch))  return false ;
+		*word = (*word << 4) | htob(ch);
 	}
+	if (!isgap(prontoChar(cp, pgm)))  return false ;
 
-	// We will use cp to traverse the string
-	cp = s;
+	*pcp = cp;
+	return true;
+}
 
-	// Check mode = Oscillated/Learned
-	byp(&cp);
-	if (htow(cp) != 0000)  return false;
-	cp += 4;
-
-	// Extract & set frequency
-	byp(&cp);
-	freq = (int)(1000000 / (htow(cp) * 0.241246));  // Rounding errors will occur, tolerance is +/- 10%
-	usec = (int)(((1.0 / freq) * 1000000) + 0.5);  // Another rounding error, thank Cod for analogue electronics
-	freq /= 1000;  // This will introduce a(nother) rounding error which we do not want in the usec calcualtion
-	cp += 4;
-
-	// Get length of "once" code
-	byp(&cp);
-	once = htow(cp);
-	cp += 4;
-
-	// Get length of "repeat" code
-	byp(&cp);
-	rpt = htow(cp);
-	cp += 4;
-
-	// Which code are we sending?
-	if (fallback) { // fallback on the "other" code if "this" code is not present
-		if (!repeat) { // requested 'once'
-			if (once)  len = once * 2,  skip = 0 ;  // if once exists send it
-			else       len = rpt  * 2,  skip = 0 ;  // else send repeat code
-		} else { // requested 'repeat'
-			if (rpt)   len = rpt  * 2,  skip = 0 ;  // if rpt exists send it
-			else       len = once * 2,  skip = 0 ;  // else send once code
-		}
-	} else {  // Send what we asked for, do not fallback if the code is empty!
-		if (!repeat)  len = once * 2,  skip = 0 ;     // 'once' starts at 0
-		else          len = rpt  * 2,  skip = once ;  // 'repeat' starts where 'once' ends
-    }
+//+=============================================================================
+// Read the 4 word preamble of a Pronto code
+// Returns the carrier period in 1/256ths of a uS, or 0 if the code is no good
+//
+static unsigned int  prontoHeader (const char **pcp,  bool pgm,
+                                   unsigned long *hz,  uint16_t *once,  uint16_t *rpt)
+{
+	uint16_t  form, carrier;
 
-	// Skip to start of code
-	for (i = 0;  i < skip;  i++, cp += 4)  byp(&cp) ;
+	if (!prontoWord(pcp, pgm, &form) || (form != 0x0000))  return 0 ;  // Only Oscillated
+	if (!prontoWord(pcp, pgm, &carrier) || !carrier)       return 0 ;
+	if (!prontoWord(pcp, pgm, once))                       return 0 ;
+	if (!prontoWord(pcp, pgm, rpt))                        return 0 ;
 
-	// Send code
-	enableIROut(freq);
-	for (i = 0;  i < len;  i++) {
-		byp(&cp);
-		if (i & 1)  space(htow(cp) * usec);
-		else        mark (htow(cp) * usec);
-		cp += 4;
-	}
+	// The Pronto timebase is 0.241246uS, so the carrier is 4145146 / carrier Hz
+	*hz = (4145146UL + (carrier / 2)) / carrier;
+	if ((*hz < PRONTO_MIN_KHZ * 1000UL) || (*hz > PRONTO_MAX_KHZ * 1000UL))  return 0 ;
+
+	// 0.241246 * 256 = 61.759
+	return ((unsigned long)carrier * 61759 + 500) / 1000;
 }
 
 //+=============================================================================
-#if TEST
+// Length of a count of carrier periods in uS
+// Only a lead-out is long enough to need clipping to what space() can take
+//
+static unsigned int  prontoUsecs (uint16_t count,  unsigned int period)
+{
+	unsigned long  usecs = ((unsigned long)count * period + 128) >> 8;
+	return (usecs > 0xFFFF) ? 0xFFFF : usecs ;
+}
 
-int  main ( )
+//+=============================================================================
+// Pick the part of a code to send; see PRONTO_FALLBACK in IRremote.h
+// once and rpt are counts of mark/space pairs
+//
+static void  prontoPick (unsigned int once,  unsigned int rpt,  bool repeat,  bool fallback,
+                         unsigned int *start,  unsigned int *len)
 {
-	char  prontoTest[] =
-		"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
-		"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
-		"0010 0030 0010 0aa6";                               // 104
-
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_FALLBACK);    // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_FALLBACK);    // repeat code
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_NOFALLBACK);  // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_NOFALLBACK);  // repeat code
+	bool  sendrpt = repeat;
 
-	return 0;
+	// fallback on the "other" code if "this" code is not present
+	if (fallback)  sendrpt = repeat ? (rpt != 0) : (once == 0) ;
+
+	*start = sendrpt ? once * 2 : 0 ;  // 'repeat' starts where 'once' ends
+	*len   = sendrpt ? rpt  * 2 : once * 2 ;
+}
+
+//+=============================================================================
+// Parse (and check) a Pronto string once, so that it can be sent any number of
+//   times without parsing it again.  Any blanks between the blocks will do.
+// The durations go in buf, which needs room for 2 * (once + repeat) entries;
+//   code then refers to buf, so buf must last as long as code does.
+// Returns false if the string is not a valid Oscillated code, or is too long.
+//
+static bool  prontoCompile (const char *s,  bool pgm,  ProntoCode *code,
+                            unsigned int *buf,  unsigned int size)
+{
+	uint16_t      once, rpt, count;
+	unsigned int  period = prontoHeader(&s, pgm, &code->hz, &once, &rpt);
+
+	if (!period)                             return false ;
+	if (2UL * (once + rpt) > size)           return false ;
+
+	for (unsigned int i = 0;  i < 2U * (once + rpt);  i++) {
+		if (!prontoWord(&s, pgm, &count))    return false ;
+		buf[i] = prontoUsecs(count, period);
+	}
+	if (prontoWord(&s, pgm, &count))         return false ;  // Too many blocks
+	while (isgap(prontoChar(s, pgm)) && prontoChar(s, pgm))  s++ ;
+	if (prontoChar(s, pgm))                  return false ;  // Rubbish on the end
+
+	code->once = once;
+	code->rpt  = rpt;
+	code->data = buf;
+	return true;
+}
+
+bool  IRsend::compilePronto (const char *s,  ProntoCode *code,  unsigned int *buf,  unsigned int size)
+{
+	return prontoCompile(s, false, code, buf, size);
 }
 
-#endif // TEST
+// The same, with s in flash:  compilePronto_P(PSTR("0000 006D ..."), ...)
+bool  IRsend::compilePronto_P (PGM_P s,  ProntoCode *code,  unsigned int *buf,  unsigned int size)
+{
+	return prontoCompile(s, true, code, buf, size);
+}
+
+//+=============================================================================
+// Send a compiled code: there is nothing left to work out between the marks
+//
+void  IRsend::sendPronto (const ProntoCode *code,  bool repeat,  bool fallback)
+{
+	unsigned int  start, len;
+
+	prontoPick(code->once, code->rpt, repeat, fallback, &start, &len);
+	if (!len)  return ;
+
+	enableIROutHz(code->hz);
+	for (unsigned int i = start;  i < start + len;  i++) {
+		if (i & 1)  space(code->data[i]) ;
+		else        mark (code->data[i]) ;
+	}
+	space(0);  // Always end with the LED off
+}
+
+#if SENDBUF
+//+=============================================================================
+// Queue a compiled code for the send interrupt; see sendRawAsync()
+// A code longer than SENDBUF entries (less 4) can never fit
+//
+bool  IRsend::sendProntoAsync (const ProntoCode *code,  bool repeat,  bool fallback)
+{
+	queueBegin();
+	sendPronto(code, repeat, fallback);
+	return queueEnd();
+}
+#endif
+
+//+=============================================================================
+// Send a Pronto string directly
+// This parses the string as it goes, so it is slow; a code which is sent more
+//   than once is better compiled with compilePronto() and sent from that
+//
+void  IRsend::sendPronto (char* s,  bool repeat,  bool fallback)
+{
+	const char    *cp = s;
+	unsigned long  hz;
+	unsigned int   start, len;
+	uint16_t       once, rpt, count;
+	unsigned int   period = prontoHeader(&cp, false, &hz, &once, &rpt);
+
+	if (!period)  return ;
+
+	prontoPick(once, rpt, repeat, fallback, &start, &len);
+
+	// Skip to start of code
+	for (unsigned int i = 0;  i < start;  i++)
+		if (!prontoWord(&cp, false, &count))  return ;
+
+	// Send code
+	enableIROutHz(hz);
+	for (unsigned int i = 0;  i < len;  i++) {
+		if (!prontoWord(&cp, false, &count))  break ;
+		if (i & 1)  space(prontoUsecs(count, period));
+		else        mark (prontoUsecs(count, period));
+	}
+	space(0);  // Always end with the LED off
+}
 
 #endif // SEND_PRONTO
 
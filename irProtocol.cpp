@@ -0,0 +1,165 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//           PPPP   RRRR    OOO   TTTTT   OOO    CCCC   OOO   L
+//           P   P  R   R  O   O    T    O   O  C      O   O  L
+//           PPPP   RRRR   O   O    T    O   O  C      O   O  L
+//           P      R  R   O   O    T    O   O  C      O   O  L
+//           P      R   R   OOO     T     OOO    CCCC   OOO   LLLLL
+//==============================================================================
+
+// Table driven protocols
+// Most remotes send a header, a fixed number of pulse distance (or pulse width)
+//   bits and a trailing mark; all that differs between them is the timings.
+// An ir_protocol_t (IRremote.h) holds those timings, in flash, and the one
+//   encoder and decoder here do the rest, for the protocols of the ir_*.cpp
+//   files which fit and for any a sketch adds of its own.
+
+//+=============================================================================
+// One bit: a fixed mark and a one or zero space, or for a pulse width code, a
+//   fixed space and a one or zero mark
+//
+static void  sendProtocolBit (IRsend &irsend,  const ir_protocol_t &p,  bool one)
+{
+	unsigned int  t = one ? p.bit_one : p.bit_zero;
+
+	if (p.flags & IR_PROTO_PULSE_WIDTH) {
+		irsend.space(p.bit_fixed);
+		irsend.mark(t);
+	} else {
+		irsend.mark(p.bit_fixed);
+		irsend.space(t);
+	}
+}
+
+//+=============================================================================
+// Send a code of a table driven protocol
+// With repeat, send its repeat form: NEC's short ditto, the frame without its
+//   header, or if it has neither, the frame again
+//
+void  IRsend::sendProtocol (const ir_protocol_t *proto,  unsigned long data,  int nbits,  bool repeat)
+{
+	ir_protocol_t  p;
+
+	memcpy_P(&p, proto, sizeof(p));
+	if (nbits <= 0)  nbits = p.bits ;
+
+	// Set IR carrier frequency, and the repeat period for encode()
+	enableIROut(p.khz);
+	encode_period = p.period;
+
+	// Ditto
+	if (repeat && p.rpt_space) {
+		mark(p.hdr_mark);
+		space(p.rpt_space);
+		mark(p.bit_fixed);
+		space(0);  // Always end with the LED off
+		return;
+	}
+
+	// Start bit & Header
+	if (p.flags & IR_PROTO_START_BIT)  sendProtocolBit(*this, p, false) ;
+	if (!repeat || !(p.flags & IR_PROTO_RPT_NOHDR)) {
+		if (p.hdr_mark)   mark(p.hdr_mark) ;
+		if (p.hdr_space)  space(p.hdr_space) ;
+	}
+
+	// Data
+	if (p.flags & IR_PROTO_LSB_FIRST) {
+		for (int i = 0;  i < nbits;  i++, data >>= 1)  sendProtocolBit(*this, p, data & 1) ;
+	} else {
+		for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1)  sendProtocolBit(*this, p, data & mask) ;
+	}
+
+	// Footer
+	if (p.footer)  mark(p.footer) ;
+	space(0);  // Always end with the LED off
+}
+
+//+=============================================================================
+// Render a code of a table driven protocol into buf (of size entries), to send
+//   with sendSequence()
+//
+bool  IRsend::encodeProtocol (IRframe *frame,  unsigned int *buf,  unsigned int size,
+                              const ir_protocol_t *proto,  unsigned long data,  int nbits,  bool repeat)
+{
+	encodeBegin(frame, buf, size);
+	sendProtocol(proto, data, nbits, repeat);
+	return encodeEnd();
+}
+
+//+=============================================================================
+// Decode a frame as a table driven protocol
+// A repeat (either form) is returned as REPEAT, with no bits
+//
+bool  IRrecv::decodeProtocol (decode_results *results,  const ir_protocol_t *proto)
+{
+	ir_protocol_t  p;
+	unsigned long  data   = 0;
+	int            offset = 1;  // Skip the Gap reading
+	int            hdr;         // Entries in the header
+	int            len;         // ... and in the whole frame
+
+	memcpy_P(&p, proto, sizeof(p));
+	hdr = (p.hdr_mark ? 1 : 0) + (p.hdr_space ? 1 : 0);
+	len = 1 + ((p.flags & IR_PROTO_START_BIT) ? 2 : 0) + hdr + (2 * p.bits) + (p.footer ? 1 : 0);
+
+	// All the tick windows were worked out by IR_PROTOCOL(), so each check is
+	//   two compares
+
+	// Check for a ditto, or a frame without its header
+	if (   (p.rpt_space && (results->rawlen == 4)
+	        && IN_WINDOW((int)results->rawbuf[1], p.hdr_mark_low,  p.hdr_mark_high)
+	        && IN_WINDOW((int)results->rawbuf[2], p.rpt_space_low, p.rpt_space_high)
+	        && IN_WINDOW((int)results->rawbuf[3], p.bit.fixed_low, p.bit.fixed_high))
+	    || ((p.flags & IR_PROTO_RPT_NOHDR) && hdr && p.footer && (results->rawlen == len - hdr)
+	        && IN_WINDOW((int)results->rawbuf[1], p.bit.fixed_low, p.bit.fixed_high)
+	        && IN_WINDOW((int)results->rawbuf[results->rawlen - 1], p.footer_low, p.footer_high))
+	   ) {
+		results->bits        = 0;
+		results->value       = REPEAT;
+		results->decode_type = (decode_type_t)p.type;
+		return true;
+	}
+
+	// Check we have the right amount of data
+	if (p.flags & IR_PROTO_EXACT_LEN) {
+		if (results->rawlen != len)  return false ;
+	} else {
+		if (results->rawlen < len)   return false ;
+	}
+
+	// Start bit, which is a zero
+	if (p.flags & IR_PROTO_START_BIT) {
+		if (!decodePulseDistance(results, &offset, 1, &p.bit, &data) || data)  return false ;
+	}
+
+	// Header
+	if (p.hdr_mark) {
+		if (!IN_WINDOW((int)results->rawbuf[offset], p.hdr_mark_low,  p.hdr_mark_high ))  return false ;
+		offset++;
+	}
+	if (p.hdr_space) {
+		if (!IN_WINDOW((int)results->rawbuf[offset], p.hdr_space_low, p.hdr_space_high))  return false ;
+		offset++;
+	}
+
+	// Data (decodePulseDistance() only needs the windows, so it reads pulse
+	//   width bits as well)
+	if (!decodePulseDistance(results, &offset, p.bits, &p.bit, &data))  return false ;
+	if (p.flags & IR_PROTO_LSB_FIRST) {
+		unsigned long  msb = 0;
+		for (int i = 0;  i < p.bits;  i++, data >>= 1)  msb = (msb << 1) | (data & 1) ;
+		data = msb;
+	}
+
+	// Footer
+	if (p.footer && !IN_WINDOW((int)results->rawbuf[offset], p.footer_low, p.footer_high))  return false ;
+
+	// Success
+	results->bits        = p.bits;
+	results->value       = data;
+	results->decode_type = (decode_type_t)p.type;
+	return true;
+}
@@ -6,6 +6,181 @@ hw_timer_t *timer;
 void IRTimer(); // defined in IRremote.cpp
 #endif
 
+//+=============================================================================
+// Pick out the decoders which could possibly match the received frame
+// One look at the frame length, header mark and leading gap rules out nearly
+//   every protocol, so decode() does not pay for a string of failed attempts.
+// Each test here is one the decoder itself makes before it will accept a
+//   frame, so a skipped decoder could never have matched.
+// The timings are the decoders' own, from irTimings.h; the lengths are those
+//   the decoders check for - if you change a decoder, keep this in step with it!
+// test/test_candidates.cpp checks that on 400000 made up frames no decoder
+//   candidates() leaves out would have taken the frame; run it after a change.
+//
+#define MARK_IS(us)  ((mark >= TICKS_LOW((us) + MARK_EXCESS)) && (mark <= TICKS_HIGH((us) + MARK_EXCESS)))
+
+unsigned long  IRrecv::candidates (decode_results *results)
+{
+	unsigned long  cand = 0;
+	int            len  = results->rawlen;
+	unsigned int   gap  = results->rawbuf[0];  // Sony & Sanyo spot repeats by the gap
+	int            mark = results->rawbuf[1];  // Header mark, as MATCH_MARK() sees it
+
+#if DECODE_NEC
+	if (MARK_IS(NEC_HDR_MARK) && ((len == 4) || (len >= (2 * NEC_BITS) + 4)))
+	                                                       cand |= CANDIDATE(NEC) ;
+#endif
+#if DECODE_SONY
+	if ((len >= (2 * SONY_BITS) + 2)
+	    && ((gap < SONY_DOUBLE_SPACE_USECS / USECPERTICK) || MARK_IS(SONY_HDR_MARK)))
+	                                                       cand |= CANDIDATE(SONY) ;
+#endif
+#if DECODE_SANYO
+	if ((len >= (2 * SANYO_BITS) + 2)
+	    && ((gap < SANYO_DOUBLE_SPACE_USECS / USECPERTICK) || MARK_IS(SANYO_HDR_MARK)))
+	                                                       cand |= CANDIDATE(SANYO) ;
+#endif
+#if DECODE_MITSUBISHI
+	if ((len >= (2 * MITSUBISHI_BITS) + 2) && MARK_IS(MITSUBISHI_HDR_SPACE))
+	                                                       cand |= CANDIDATE(MITSUBISHI) ;
+#endif
+#if DECODE_RC5
+	if ((len >= MIN_RC5_SAMPLES + 2) && MARK_IS(RC5_T1))   cand |= CANDIDATE(RC5) ;
+#endif
+#if DECODE_RC6
+	if (MARK_IS(RC6_HDR_MARK))                             cand |= CANDIDATE(RC6) ;
+#endif
+#if DECODE_PANASONIC
+	if (MARK_IS(PANASONIC_HDR_MARK))                       cand |= CANDIDATE(PANASONIC) ;
+#endif
+#if DECODE_LG
+	if ((len >= (2 * LG_BITS) + 1) && MARK_IS(LG_HDR_MARK))  cand |= CANDIDATE(LG) ;
+#endif
+#if DECODE_JVC
+	if (((len == (2 * JVC_BITS) + 2) && MARK_IS(JVC_BIT_MARK))        // Repeat
+	    || ((len >= (2 * JVC_BITS) + 1) && MARK_IS(JVC_HDR_MARK)))
+	                                                       cand |= CANDIDATE(JVC) ;
+#endif
+#if DECODE_SAMSUNG
+	if (MARK_IS(SAMSUNG_HDR_MARK) && ((len == 4) || (len >= (2 * SAMSUNG_BITS) + 4)))
+	                                                       cand |= CANDIDATE(SAMSUNG) ;
+#endif
+#if DECODE_WHYNTER
+	if ((len >= (2 * WHYNTER_BITS) + 6) && MARK_IS(WHYNTER_BIT_MARK))  // The start bit
+	                                                       cand |= CANDIDATE(WHYNTER) ;
+#endif
+#if DECODE_AIWA_RC_T501
+	if ((len >= (2 * AIWA_RC_T501_SUM_BITS) + 4) && MARK_IS(AIWA_RC_T501_HDR_MARK))
+	                                                       cand |= CANDIDATE(AIWA_RC_T501) ;
+#endif
+#if DECODE_DENON
+	if ((len == (2 * DENON_BITS) + 4) && MARK_IS(DENON_HDR_MARK))
+	                                                       cand |= CANDIDATE(DENON) ;
+#endif
+#if DECODE_RSTEP
+	if ((len >= 11) && (mark >= RSTEP_FIRST_MARK_MIN / USECPERTICK) && (mark < RSTEP_FIRST_MARK_MAX / USECPERTICK))
+	                                                       cand |= CANDIDATE(RSTEP) ;
+#endif
+#if DECODE_LEGO_PF
+	cand |= CANDIDATE(LEGO_PF);
+#endif
+
+	return cand;
+}
+
+//+=============================================================================
+// Called from the ISRs as each mark ends, when earlyEnd() has been used, so
+//   it is IR_ISR_ATTR (boarddefs.h) and only uses constant tests
+// True if what has been recorded is already a whole frame of one of the
+//   protocols in irp.early, so there is no need to wait for the gap.
+// Only protocols with a fixed length and a header qualify; the tests are
+//   those of candidates() plus the header space.
+//
+#define SPACE_IS(us)  ((space >= TICKS_LOW((us) - MARK_EXCESS)) && (space <= TICKS_HIGH((us) - MARK_EXCESS)))
+
+bool  IR_ISR_ATTR  irEarlyEnd (volatile irparams_t &irp)
+{
+	unsigned long  early = irp.early;
+	unsigned int   len   = irp.rawlen;
+
+	if (len < 4)  return false ;
+
+	int  mark  = RAWBUF_VIEW(irp, irp.rawbuf, irp.head)[1];
+	int  space = RAWBUF_VIEW(irp, irp.rawbuf, irp.head)[2];
+
+#if DECODE_NEC
+	if ((early & CANDIDATE(NEC)) && MARK_IS(NEC_HDR_MARK)) {
+		if ((len == 4) && SPACE_IS(NEC_RPT_SPACE))                            return true ;  // Repeat
+		if ((len == (2 * NEC_BITS) + 4) && SPACE_IS(NEC_HDR_SPACE))           return true ;
+	}
+#endif
+#if DECODE_SAMSUNG
+	if ((early & CANDIDATE(SAMSUNG)) && MARK_IS(SAMSUNG_HDR_MARK)) {
+		if ((len == 4) && SPACE_IS(SAMSUNG_RPT_SPACE))                        return true ;  // Repeat
+		if ((len == (2 * SAMSUNG_BITS) + 4) && SPACE_IS(SAMSUNG_HDR_SPACE))   return true ;
+	}
+#endif
+#if DECODE_LG
+	if ((early & CANDIDATE(LG)) && MARK_IS(LG_HDR_MARK) && SPACE_IS(LG_HDR_SPACE)
+	    && (len == (2 * LG_BITS) + 4))                                    return true ;
+#endif
+#if DECODE_JVC
+	if ((early & CANDIDATE(JVC)) && MARK_IS(JVC_HDR_MARK) && SPACE_IS(JVC_HDR_SPACE)
+	    && (len == (2 * JVC_BITS) + 4))                                   return true ;
+#endif
+
+	return false;
+}
+
+
+//+=============================================================================
+// Try one decoder, and return if it worked
+// With IR_STATS, count the try (and its cycles) against the protocol
+//
+#if IR_STATS
+#	define IR_TRY(type, call)  do {                                  \
+		unsigned long  t0 = IR_CYCLES();                             \
+		bool           ok = (call);                                  \
+		decstats.cycles[(type) + 1] += IR_CYCLES() - t0;             \
+		decstats.tries[(type) + 1]++;                                \
+		if (ok) {                                                    \
+			decstats.hits[(type) + 1]++;                             \
+			return true;                                             \
+		}                                                            \
+	} while (0)
+#else
+#	define IR_TRY(type, call)  do { if (call)  return true ; } while (0)
+#endif
+
+//+=============================================================================
+// Point results at the next frame to decode; false if there isn't one yet
+//
+bool  IRrecv::fetch (decode_results *results)
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	checkGap();
+
+#if (RAWBUF_FRAMES > 1)
+	// Oldest queued frame first; the ISR never touches a queued slot
+	if (irp.queued) {
+		results->rawbuf   = RAWBUF_VIEW(irp, irp.frames[irp.tail], irp.tail);
+		results->rawlen   = irp.framelen[irp.tail];
+		results->overflow = irp.frameovf[irp.tail];
+	} else
+#endif
+	{
+		results->rawbuf   = RAWBUF_VIEW(irp, irp.rawbuf, irp.head);
+		results->rawlen   = irp.rawlen;
+
+		results->overflow = irp.overflow;
+
+		if (irp.rcvstate != STATE_STOP)  return false ;
+	}
+
+	return true;
+}
+
 //+=============================================================================
 // Decodes the received IR message
 // Returns 0 if no data ready, 1 if data ready.
@@ -13,92 +188,120 @@ void IRTimer(); // defined in IRremote.cpp
 //
 int  IRrecv::decode (decode_results *results)
 {
-	results->rawbuf   = irparams.rawbuf;
-	results->rawlen   = irparams.rawlen;
-
-	results->overflow = irparams.overflow;
+	if (!fetch(results))  return false ;
 
-	if (irparams.rcvstate != STATE_STOP)  return false ;
+	// Only try the decoders which could match this frame
+	unsigned long  cand = candidates(results);
 
 #if DECODE_NEC
-	DBG_PRINTLN("Attempting NEC decode");
-	if (decodeNEC(results))  return true ;
+	if (cand & CANDIDATE(NEC)) {
+		DBG_PRINTLN("Attempting NEC decode");
+		IR_TRY(NEC, decodeNEC(results));
+	}
 #endif
 
 #if DECODE_SONY
-	DBG_PRINTLN("Attempting Sony decode");
-	if (decodeSony(results))  return true ;
+	if (cand & CANDIDATE(SONY)) {
+		DBG_PRINTLN("Attempting Sony decode");
+		IR_TRY(SONY, decodeSony(results));
+	}
 #endif
 
 #if DECODE_SANYO
-	DBG_PRINTLN("Attempting Sanyo decode");
-	if (decodeSanyo(results))  return true ;
+	if (cand & CANDIDATE(SANYO)) {
+		DBG_PRINTLN("Attempting Sanyo decode");
+		IR_TRY(SANYO, decodeSanyo(results));
+	}
 #endif
 
 #if DECODE_MITSUBISHI
-	DBG_PRINTLN("Attempting Mitsubishi decode");
-	if (decodeMitsubishi(results))  return true ;
+	if (cand & CANDIDATE(MITSUBISHI)) {
+		DBG_PRINTLN("Attempting Mitsubishi decode");
+		IR_TRY(MITSUBISHI, decodeMitsubishi(results));
+	}
 #endif
 
 #if DECODE_RC5
-	DBG_PRINTLN("Attempting RC5 decode");
-	if (decodeRC5(results))  return true ;
+	if (cand & CANDIDATE(RC5)) {
+		DBG_PRINTLN("Attempting RC5 decode");
+		IR_TRY(RC5, decodeRC5(results));
+	}
 #endif
 
 #if DECODE_RC6
-	DBG_PRINTLN("Attempting RC6 decode");
-	if (decodeRC6(results))  return true ;
+	if (cand & CANDIDATE(RC6)) {
+		DBG_PRINTLN("Attempting RC6 decode");
+		IR_TRY(RC6, decodeRC6(results));
+	}
 #endif
 
 #if DECODE_PANASONIC
-	DBG_PRINTLN("Attempting Panasonic decode");
-	if (decodePanasonic(results))  return true ;
+	if (cand & CANDIDATE(PANASONIC)) {
+		DBG_PRINTLN("Attempting Panasonic decode");
+		IR_TRY(PANASONIC, decodePanasonic(results));
+	}
 #endif
 
 #if DECODE_LG
-	DBG_PRINTLN("Attempting LG decode");
-	if (decodeLG(results))  return true ;
+	if (cand & CANDIDATE(LG)) {
+		DBG_PRINTLN("Attempting LG decode");
+		IR_TRY(LG, decodeLG(results));
+	}
 #endif
 
 #if DECODE_JVC
-	DBG_PRINTLN("Attempting JVC decode");
-	if (decodeJVC(results))  return true ;
+	if (cand & CANDIDATE(JVC)) {
+		DBG_PRINTLN("Attempting JVC decode");
+		IR_TRY(JVC, decodeJVC(results));
+	}
 #endif
 
 #if DECODE_SAMSUNG
-	DBG_PRINTLN("Attempting SAMSUNG decode");
-	if (decodeSAMSUNG(results))  return true ;
+	if (cand & CANDIDATE(SAMSUNG)) {
+		DBG_PRINTLN("Attempting SAMSUNG decode");
+		IR_TRY(SAMSUNG, decodeSAMSUNG(results));
+	}
 #endif
 
 #if DECODE_WHYNTER
-	DBG_PRINTLN("Attempting Whynter decode");
-	if (decodeWhynter(results))  return true ;
+	if (cand & CANDIDATE(WHYNTER)) {
+		DBG_PRINTLN("Attempting Whynter decode");
+		IR_TRY(WHYNTER, decodeWhynter(results));
+	}
 #endif
 
 #if DECODE_AIWA_RC_T501
-	DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
-	if (decodeAiwaRCT501(results))  return true ;
+	if (cand & CANDIDATE(AIWA_RC_T501)) {
+		DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
+		IR_TRY(AIWA_RC_T501, decodeAiwaRCT501(results));
+	}
 #endif
 
 #if DECODE_DENON
-	DBG_PRINTLN("Attempting Denon decode");
-	if (decodeDenon(results))  return true ;
+	if (cand & CANDIDATE(DENON)) {
+		DBG_PRINTLN("Attempting Denon decode");
+		IR_TRY(DENON, decodeDenon(results));
+	}
 #endif
 
 #if DECODE_RSTEP
-	DBG_PRINTLN("Attempting Ruwido rStep 38kHz and 56kHz decode");
-	if (decodeRstep(results))  return true;
+	if (cand & CANDIDATE(RSTEP)) {
+		DBG_PRINTLN("Attempting Ruwido rStep 38kHz and 56kHz decode");
+		IR_TRY(RSTEP, decodeRstep(results));
+	}
 #endif
 
 #if DECODE_LEGO_PF
-	DBG_PRINTLN("Attempting Lego Power Functions");
-	if (decodeLegoPowerFunctions(results))  return true ;
+	if (cand & CANDIDATE(LEGO_PF)) {
+		DBG_PRINTLN("Attempting Lego Power Functions");
+		IR_TRY(LEGO_PF, decodeLegoPowerFunctions(results));
+	}
 #endif
 
 	// decodeHash returns a hash on any input.
 	// Thus, it needs to be last in the list.
 	// If you add any decodes, add them before this.
-	if (decodeHash(results))  return true ;
+	IR_TRY(UNKNOWN, decodeHash(results));
 
 	// Throw away and start over
 	resume();
@@ -106,51 +309,142 @@ int  IRrecv::decode (decode_results *results)
 }
 
 //+=============================================================================
-IRrecv::IRrecv (int recvpin)
+// Each IRrecv gets a receiver state of its own, up to IR_RECEIVERS of them
+//
+static uint8_t  irRegister (int recvpin,  int blinkpin,  bool inverted_input)
+{
+	uint8_t               rx  = (irreceivers < IR_RECEIVERS) ? irreceivers++ : IR_RECEIVERS - 1 ;
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	irp.rawbuf = irp.frames[0];
+	irp.rawsize = RAWBUF;
+	irp.recvpin = recvpin;
+	irp.blinkpin = blinkpin;
+	if (blinkpin)  pinMode(blinkpin, OUTPUT) ;
+	irp.blinkflag = 0;
+	irp.inverted_input = inverted_input;
+
+	return rx;
+}
+
+//+=============================================================================
+// What every constructor does
+//
+void  IRrecv::init (int recvpin,  int blinkpin,  bool inverted_input)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkflag = 0;
-	irparams.inverted_input = false;
+	rx      = irRegister(recvpin, blinkpin, inverted_input);
+	keyDown = false;
+#if IR_STATS
+	memset(&decstats, 0, sizeof(decstats));
+#endif
 }
 
+IRrecv::IRrecv (int recvpin)
+{
+	init(recvpin, 0, false);
+}
+
 IRrecv::IRrecv (int recvpin, bool inverted_input)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkflag = 0;
-	irparams.inverted_input = inverted_input;
+	init(recvpin, 0, inverted_input);
 }
 
 IRrecv::IRrecv (int recvpin, int blinkpin)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkpin = blinkpin;
-	pinMode(blinkpin, OUTPUT);
-	irparams.blinkflag = 0;
-	irparams.inverted_input = false;
+	init(recvpin, blinkpin, false);
 }
 
 IRrecv::IRrecv (int recvpin, int blinkpin, bool inverted_input)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkpin = blinkpin;
-	pinMode(blinkpin, OUTPUT);
-	irparams.blinkflag = 0;
-	irparams.inverted_input = inverted_input;
+	init(recvpin, blinkpin, inverted_input);
 }
+
+#ifdef IR_WAKE_ATTACHED
+//+=============================================================================
+// Put the low power wake up interrupt on a timer receiver's pin (boarddefs.h)
+//
+static void  irWakeAttach (volatile irparams_t &irp)
+{
+	attachInterrupt(digitalPinToInterrupt(irp.recvpin), irEdgeISR[&irp - irrecvs],
+	                irp.inverted_input ? RISING : IR_WAKE_TRIGGER);
+}
+#endif
+
 //+=============================================================================
 // initialization
+// IR_RECV_TIMER samples the input pin every USECPERTICK uS (the default)
+// IR_RECV_EDGE  only takes an interrupt when the input pin changes
+// Receivers may use either; one timer ISR serves all of those using the timer
 //
-void  IRrecv::enableIRIn ( )
+void  IRrecv::enableIRIn (bool edge)
 {
-// Interrupt Service Routine - Fires every 50uS
+	volatile irparams_t  &irp = irrecvs[rx];
+
+#ifdef digitalPinToInterrupt
+	// Asleep in low power mode: take the wake up interrupt off the pin
+	if (irp.asleep) {
+#	ifndef IR_WAKE_ATTACHED
+		detachInterrupt(digitalPinToInterrupt(irp.recvpin));
+#	endif
+		irp.asleep = false;
+	}
+#endif
+
+	// Initialize state machine variables
+	irp.rcvstate = STATE_IDLE;
+	irp.rawlen = 0;
+	irp.lastedge = micros();
+	irp.woken = false;  // No wake up mark pending from before
+#if IR_STATS
+	IR_CYCLES_INIT();
+#endif
+
+	// Set pin modes
+	pinMode(irp.recvpin, INPUT);
+
+#ifdef IR_FAST_PINS
+	// Look the pins up now, so the ISR does not have to
+	irp.recvreg  = portInputRegister(digitalPinToPort(irp.recvpin));
+	irp.recvmask = digitalPinToBitMask(irp.recvpin);
+	if (irp.blinkpin) {
+		irp.blinkreg  = portOutputRegister(digitalPinToPort(irp.blinkpin));
+		irp.blinkmask = digitalPinToBitMask(irp.blinkpin);
+	}
+#endif
+
+#ifdef digitalPinToInterrupt
+	// Edge interrupts, if the pin can provide them
+	if (edge && (digitalPinToInterrupt(irp.recvpin) != NOT_AN_INTERRUPT)) {
+		irp.edgemode = true;
+		if (!irTimerBusy()) {
+#	ifdef ESP32
+			if (timer)  timerAlarmDisable(timer) ;
+#	else
+			TIMER_DISABLE_INTR;
+#	endif
+		}
+		attachInterrupt(digitalPinToInterrupt(irp.recvpin), irEdgeISR[rx], CHANGE);
+		return;
+	}
+
+	if (irp.edgemode)  detachInterrupt(digitalPinToInterrupt(irp.recvpin)) ;
+#	ifdef IR_WAKE_ATTACHED
+	if (irp.lowpower)  irWakeAttach(irp) ;
+#	endif
+#endif
+	irp.edgemode = false;
+
+// Interrupt Service Routine - Fires every USECPERTICK uS
 #ifdef ESP32
 	// ESP32 has a proper API to setup timers, no weird chip macros needed
 	// simply call the readable API versions :)
 	// 3 timers, choose #1, 80 divider nanosecond precision, 1 to count up
-	timer = timerBegin(1, 80, 1);
-	timerAttachInterrupt(timer, &IRTimer, 1);
-	// every 50ns, autoreload = true
-	timerAlarmWrite(timer, 50, true);
+	if (!timer) {  // Once, however many receivers use it
+		timer = timerBegin(1, 80, 1);
+		timerAttachInterrupt(timer, &IRTimer, 1);
+		// every USECPERTICK uS, autoreload = true
+		timerAlarmWrite(timer, USECPERTICK, true);
+	}
 	timerAlarmEnable(timer);
 #else
 	cli();
@@ -167,13 +461,6 @@ void  IRrecv::enableIRIn ( )
 
 	sei();  // enable interrupts
 #endif
-
-	// Initialize state machine variables
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
-
-	// Set pin modes
-	pinMode(irparams.recvpin, INPUT);
 }
 
 //+=============================================================================
@@ -181,24 +468,485 @@ void  IRrecv::enableIRIn ( )
 //
 void  IRrecv::blink13 (int blinkflag)
 {
-	irparams.blinkflag = blinkflag;
+	irrecvs[rx].blinkflag = blinkflag;
 	if (blinkflag)  pinMode(BLINKLED, OUTPUT) ;
 }
 
+//+=============================================================================
+// With the edge engine we keep receiving while IRsend is sending, and if the
+//   detector can see our own IR LED, we will receive what we send.
+// Set mask to drop anything received while we are sending (and for ECHO_USECS
+//   afterwards, as the detector lags behind the LED).
+//
+void  IRrecv::maskEcho (bool mask)
+{
+	irrecvs[rx].echomask = mask;
+}
+
+//+=============================================================================
+// Let frames of the given protocols, eg. CANDIDATE(NEC) | CANDIDATE(SAMSUNG),
+//   be decoded as soon as their last mark ends, rather than after _GAP (5mS)
+//   of silence.  earlyEnd(0), the default, always waits for the gap.
+// The frame is only judged by its header and length, so leave out a protocol
+//   if a remote you use sends longer frames with the same header (eg. NEC and
+//   Aiwa, or NEC, LG and JVC with each other): they would be cut short.
+//
+void  IRrecv::earlyEnd (unsigned long protocols)
+{
+	irrecvs[rx].early = protocols;
+}
+
+//+=============================================================================
+// Record in to the caller's buffer, of size entries, rather than the RAWBUF
+//   sized slot(s); for the odd long capture (air conditioners) without the RAM
+//   for that all of the time.  useBuffer(NULL, 0) goes back to the slots.
+// Frames recorded in buf are not queued: the ISR waits for resume().
+//
+void  IRrecv::useBuffer (volatile rawentry_t *buf,  unsigned int size)
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	noInterrupts();
+	if (buf && size) {
+		irp.rawbuf  = buf;
+		irp.rawsize = size;
+		irp.userbuf = true;
+	} else {
+		irp.rawbuf  = irp.frames[irp.head];
+		irp.rawsize = RAWBUF;
+		irp.userbuf = false;
+	}
+	irp.rawlen   = 0;
+	irp.rcvstate = STATE_IDLE;
+	interrupts();
+}
+
+//+=============================================================================
+// Low power receiving, for a receiver sampled by the timer
+// Once there has been no IR for IR_SLEEP_USECS, the timer interrupt is stopped
+//   and the receive pin woken by the first edge of the next code, so the MCU
+//   can sleep between button presses: see isAsleep().  The pin must have an
+//   external interrupt; false if it does not.
+// wakeUsecs is how long the MCU takes to wake from the sleep mode the sketch
+//   uses (eg. an ATmega328 at 16MHz takes 16K clocks, 1mS, from power down),
+//   which is added back on to the first mark.
+// An inverted_input receiver wakes on RISING, which an AVR cannot see from
+//   power down.
+// The first mark of a code must outlast the wake up: an AVR woken from power
+//   down by a LOW level takes no interrupt at all if the pin is HIGH again by
+//   the end of its start-up time.  From power down (1mS) that keeps codes with
+//   a long header mark - NEC, Samsung, Sony, JVC, LG, Panasonic, Sanyo, Aiwa,
+//   RC6 - but loses or mistimes the first mark of RC5 (889uS), Denon, Sharp,
+//   Whynter, Mitsubishi, Lego PF and rStep.  For those sleep in standby (the
+//   crystal keeps running, so the start-up is 6 clocks) with wakeUsecs 0, or
+//   leave low power mode off.
+//
+bool  IRrecv::lowPower (bool on,  unsigned int wakeUsecs)
+{
+#ifdef digitalPinToInterrupt
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	if (on && (digitalPinToInterrupt(irp.recvpin) == NOT_AN_INTERRUPT))  return false ;
+
+	noInterrupts();
+	irp.lowpower  = on;
+	irp.wakeusecs = wakeUsecs;
+	interrupts();
+
+#	ifdef IR_WAKE_ATTACHED
+	// Running on the timer: the wake up interrupt goes on, or comes off, now
+	if (irp.rcvstate && !irp.edgemode) {
+		if (on)  irWakeAttach(irp) ;
+		else     detachInterrupt(digitalPinToInterrupt(irp.recvpin)) ;
+	}
+#	endif
+
+	if (!on && irp.asleep)  enableIRIn(IR_RECV_TIMER) ;  // Wake it, and restart the timer
+	return true;
+#else
+	return !on;
+#endif
+}
+
+//+=============================================================================
+// true while a low power receiver has its timer stopped, waiting for IR
+// Nothing of ours needs the CPU then, so the sketch may sleep: check with
+//   interrupts disabled, so that the wake up edge cannot slip in between.
+//
+bool  IRrecv::isAsleep ( )
+{
+	return irrecvs[rx].asleep;
+}
+
 //+=============================================================================
 // Return if receiving new IR signals
 //
 bool  IRrecv::isIdle ( )
 {
- return (irparams.rcvstate == STATE_IDLE || irparams.rcvstate == STATE_STOP) ? true : false;
+	volatile irparams_t  &irp = irrecvs[rx];
+
+ checkGap();
+ return (irp.rcvstate == STATE_IDLE || irp.rcvstate == STATE_STOP) ? true : false;
+}
+//+=============================================================================
+// The edge ISR only runs when the input changes, so it cannot see the gap
+//   after the last mark of a transmission for itself.
+// If we are timing a space which has become a gap, the code is complete.
+//
+void  IRrecv::checkGap ( )
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	if (!irp.edgemode)  return ;
+
+	noInterrupts();
+	if ((irp.rcvstate == STATE_SPACE) && (micros() - irp.lastedge > _GAP))
+		irFrameDone(irp);
+	interrupts();
 }
+
 //+=============================================================================
 // Restart the ISR state machine
 //
 void  IRrecv::resume ( )
 {
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+	volatile irparams_t  &irp = irrecvs[rx];
+
+#if (RAWBUF_FRAMES > 1)
+	noInterrupts();
+	if (irp.queued) {
+		// Release the oldest frame
+		if (++irp.tail >= RAWBUF_FRAMES)  irp.tail = 0 ;
+		irp.queued--;
+
+		// If the ISR was waiting for a free slot, it can queue its frame now
+		if (irp.rcvstate == STATE_STOP)  irFrameDone(irp) ;
+		interrupts();
+		return;
+	}
+	interrupts();
+#endif
+
+	irp.rcvstate = STATE_IDLE;
+	irp.rawlen = 0;
+}
+
+//+=============================================================================
+// Number of codes lost because they arrived while every frame slot was full
+//
+unsigned int  IRrecv::overruns ( )
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	noInterrupts();
+	unsigned int  n = irp.overruns;
+	interrupts();
+	return n;
+}
+
+#if IR_STATS
+//+=============================================================================
+// What receiving has cost so far, or since clearStats()
+//
+void  IRrecv::stats (irstats_t *stats)
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	*stats = decstats;
+
+	noInterrupts();
+	stats->isrCount  = irp.stats.count;
+	stats->isrMin    = irp.stats.min;
+	stats->isrMax    = irp.stats.max;
+	stats->isrAvg    = irp.stats.avg16 >> 4;
+	stats->frames    = irp.stats.frames;
+	stats->overflows = irp.stats.overflows;
+	stats->glitches  = irp.stats.glitches;
+	stats->runts     = irp.stats.runts;
+	stats->dropped   = irp.overruns;
+	interrupts();
+}
+
+//+=============================================================================
+// Start counting again (dropped frames are overruns(), and are not cleared)
+//
+void  IRrecv::clearStats ( )
+{
+	volatile irparams_t  &irp = irrecvs[rx];
+
+	memset(&decstats, 0, sizeof(decstats));
+
+	noInterrupts();
+	irp.stats.count     = 0;
+	irp.stats.min       = 0;
+	irp.stats.max       = 0;
+	irp.stats.avg16     = 0;
+	irp.stats.frames    = 0;
+	irp.stats.overflows = 0;
+	irp.stats.glitches  = 0;
+	irp.stats.runts     = 0;
+	interrupts();
+}
+#endif
+
+//+=============================================================================
+// Decode a frame with just one decoder
+//
+bool  IRrecv::decodeAs (decode_type_t type,  decode_results *results)
+{
+	switch (type) {
+#if DECODE_NEC
+		case NEC:           return decodeNEC(results);
+#endif
+#if DECODE_SONY
+		case SONY:          return decodeSony(results);
+#endif
+#if DECODE_SANYO
+		case SANYO:         return decodeSanyo(results);
+#endif
+#if DECODE_MITSUBISHI
+		case MITSUBISHI:    return decodeMitsubishi(results);
+#endif
+#if DECODE_RC5
+		case RC5:           return decodeRC5(results);
+#endif
+#if DECODE_RC6
+		case RC6:           return decodeRC6(results);
+#endif
+#if DECODE_PANASONIC
+		case PANASONIC:     return decodePanasonic(results);
+#endif
+#if DECODE_LG
+		case LG:            return decodeLG(results);
+#endif
+#if DECODE_JVC
+		case JVC:           return decodeJVC(results);
+#endif
+#if DECODE_SAMSUNG
+		case SAMSUNG:       return decodeSAMSUNG(results);
+#endif
+#if DECODE_WHYNTER
+		case WHYNTER:       return decodeWhynter(results);
+#endif
+#if DECODE_AIWA_RC_T501
+		case AIWA_RC_T501:  return decodeAiwaRCT501(results);
+#endif
+#if DECODE_DENON
+		case DENON:         return decodeDenon(results);
+#endif
+#if DECODE_RSTEP
+		case RSTEP:         return decodeRstep(results);
+#endif
+#if DECODE_LEGO_PF
+		case LEGO_PF:       return decodeLegoPowerFunctions(results);
+#endif
+		case UNKNOWN:       return decodeHash(results);
+		default:            return false;
+	}
+}
+
+//+=============================================================================
+// decode() and decodeAs() for keyDecode(), with all the decoders
+//
+int  IRrecv::decodeAll (IRrecv &r,  decode_results *results)
+{
+	return r.decode(results);
+}
+
+bool  IRrecv::decodeAsAll (IRrecv &r,  decode_type_t type,  decode_results *results)
+{
+	return r.decodeAs(type, results);
+}
+
+//+=============================================================================
+// Is this frame the key being held?
+// First the protocol's own repeat: the NEC & Samsung "ditto" frame, JVC's
+//   frame without a header, or a Sony frame hard on the heels of the last.
+// Otherwise a frame of the same length is tried with the key's decoder alone,
+//   through decAs.
+// The timings are the decoders' own, from irTimings.h, as for candidates().
+//
+bool  IRrecv::keyRepeat (decode_results *results,  key_decode_as_t decAs)
+{
+	int  len   = results->rawlen;
+	int  mark  = results->rawbuf[1];
+	int  space = (len > 2) ? results->rawbuf[2] : 0;
+
+	switch (keyType) {
+		case NEC:
+			if ((len == 4) && MARK_IS(NEC_HDR_MARK) && SPACE_IS(NEC_RPT_SPACE))  return true ;
+			break;
+		case SAMSUNG:
+			if ((len == 4) && MARK_IS(SAMSUNG_HDR_MARK) && SPACE_IS(SAMSUNG_RPT_SPACE))  return true ;
+			break;
+		case JVC:
+			if ((len == (2 * JVC_BITS) + 2) && MARK_IS(JVC_BIT_MARK))  return true ;
+			break;
+		case SONY:
+			if ((len == keyLen) && MARK_IS(SONY_HDR_MARK)
+			    && (results->rawbuf[0] < SONY_DOUBLE_SPACE_USECS / USECPERTICK))  return true ;
+			break;
+		default:
+			break;
+	}
+
+	if (len != keyLen)  return false ;
+
+	decode_results  again = *results;
+	return decAs(*this, keyType, &again) && (again.value == keyValue) && (again.bits == keyBits);
+}
+
+//+=============================================================================
+// Put the key being tracked in results
+//
+void  IRrecv::keyResults (decode_results *results)
+{
+	results->decode_type = keyType;
+	results->value       = keyValue;
+	results->address     = keyAddress;
+	results->bits        = keyBits;
+}
+
+//+=============================================================================
+// Decode button presses rather than frames
+// Returns IR_KEY_PRESS for a new key, IR_KEY_HOLD for each repeat while it is
+//   held, IR_KEY_RELEASE once another key comes or nothing of it has for
+//   IR_KEY_RELEASE_MS, and IR_KEY_NONE otherwise; results then hold the key, see keyHeld() for how long.
+// Repeats are spotted from the repeat shape (or with just the key's own
+//   decoder), so holding a button does not run the whole decode() every frame.
+// decodeKey() calls resume() itself.
+//
+int  IRrecv::decodeKey (decode_results *results)
+{
+	return keyDecode(results, &decodeAll, &decodeAsAll);
+}
+
+//+=============================================================================
+// decodeKey(), decoding frames with dec and repeats with decAs; an IRrecvT
+//   passes its own, so that only its decoders are linked in
+//
+int  IRrecv::keyDecode (decode_results *results,  key_decode_t dec,  key_decode_as_t decAs)
+{
+	unsigned long  now = millis();
+
+	// Nothing for too long: the key is up.  Any frame waiting is kept for next time.
+	if (keyDown && (now - keyLast > IR_KEY_RELEASE_MS)) {
+		keyDown = false;
+		keyResults(results);
+		return IR_KEY_RELEASE;
+	}
+
+	if (!fetch(results))  return IR_KEY_NONE ;
+
+	if (keyDown && keyRepeat(results, decAs)) {
+		keyLast = now;
+		keyResults(results);
+		resume();
+		return IR_KEY_HOLD;
+	}
+
+	if (!dec(*this, results))  return IR_KEY_NONE ;  // decode() has dropped it
+
+	if (keyDown) {
+		// The same key after all (eg. RC5, whose repeats are whole frames)
+		if ((results->decode_type == keyType)
+		    && ((results->value == keyValue) || (results->value == REPEAT))) {
+			keyLast = now;
+			keyResults(results);
+			resume();
+			return IR_KEY_HOLD;
+		}
+
+		// Noise (UNKNOWN, while a known key is down), or a repeat of who knows
+		//   what, is no other key; the key stays down until it times out
+		if (((results->decode_type == UNKNOWN) && (keyType != UNKNOWN)) || (results->value == REPEAT)) {
+			resume();
+			return IR_KEY_NONE;
+		}
+
+		// Another key: release this one, keeping the frame to be the next press
+		keyDown = false;
+		keyResults(results);
+		return IR_KEY_RELEASE;
+	}
+
+	// A repeat code on its own says nothing about which key
+	if (results->value == REPEAT) {
+		resume();
+		return IR_KEY_NONE;
+	}
+
+	keyDown    = true;
+	keyType    = results->decode_type;
+	keyValue   = results->value;
+	keyAddress = results->address;
+	keyBits    = results->bits;
+	keyLen     = results->rawlen;
+	keyStart   = now;
+	keyLast    = now;
+	resume();
+	return IR_KEY_PRESS;
+}
+
+//+=============================================================================
+// How long the key decodeKey() last reported has been held, in mS
+//
+unsigned long  IRrecv::keyHeld ( )
+{
+	return keyLast - keyStart;
+}
+
+//+=============================================================================
+// Shared bit loops for the pulse distance and pulse width decoders
+// The tick windows in *bit are worked out by the compiler (see PULSE_DISTANCE()
+//   and PULSE_WIDTH()) so each entry costs no more than two integer compares.
+// Bits are shifted in to *data from the right (IR data is big-endian).
+//
+
+//+=============================================================================
+// Pulse distance: nbits of a fixed mark followed by a ONE or ZERO space
+// Returns false if any of the marks or spaces does not match
+//
+bool  IRrecv::decodePulseDistance (decode_results *results,  int *offset,  int nbits,
+                                   const bit_timing_t *bit,  unsigned long *data)
+{
+	int  ticks;
+
+	for (int i = 0;  i < nbits;  i++) {
+		ticks = results->rawbuf[(*offset)++];
+		if (!IN_WINDOW(ticks, bit->fixed_low, bit->fixed_high))  return false ;
+
+		ticks = results->rawbuf[(*offset)++];
+		if      (IN_WINDOW(ticks, bit->one_low,  bit->one_high ))  *data = (*data << 1) | 1 ;
+		else if (IN_WINDOW(ticks, bit->zero_low, bit->zero_high))  *data = (*data << 1) | 0 ;
+		else                                                       return false ;
+	}
+
+	return true;
+}
+
+//+=============================================================================
+// Pulse width: a fixed space followed by a ONE or ZERO mark, until the end of
+//   the frame or a space which does not match
+// Leaves *offset just past the last space tested
+// Returns false if a mark does not match
+//
+bool  IRrecv::decodePulseWidth (decode_results *results,  int *offset,
+                                const bit_timing_t *bit,  unsigned long *data)
+{
+	int  ticks;
+
+	while (*offset + 1 < results->rawlen) {
+		ticks = results->rawbuf[(*offset)++];
+		if (!IN_WINDOW(ticks, bit->fixed_low, bit->fixed_high))  break ;
+
+		ticks = results->rawbuf[(*offset)++];
+		if      (IN_WINDOW(ticks, bit->one_low,  bit->one_high ))  *data = (*data << 1) | 1 ;
+		else if (IN_WINDOW(ticks, bit->zero_low, bit->zero_high))  *data = (*data << 1) | 0 ;
+		else                                                       return false ;
+	}
+
+	return true;
 }
 
 //+=============================================================================
@@ -216,14 +964,72 @@ void  IRrecv::resume ( )
 //
 // Compare two tick values, returning 0 if newval is shorter,
 // 1 if newval is equal, and 2 if newval is longer
-// Use a tolerance of 20%
+// Use a tolerance of 20%: less than 0.8 times is 5 times less than 4 times
 //
 int  IRrecv::compare (unsigned int oldval,  unsigned int newval)
 {
-	if      (newval < oldval * .8)  return 0 ;
-	else if (oldval < newval * .8)  return 2 ;
-	else                            return 1 ;
+	if      (5UL * newval < 4UL * oldval)  return 0 ;
+	else if (5UL * oldval < 4UL * newval)  return 2 ;
+	else                                   return 1 ;
+}
+
+#if DECODE_HASH_QUANTIZE
+//+=============================================================================
+// Sort the marks (first = 1) or the spaces (first = 2) into classes of similar
+//   lengths, and number each class by how many classes are shorter.
+// An interval joins a class if it is no more than a third shorter or half
+//   again longer than the class so far, and the class stays
+//   less than 1.6 times as long at the top as at the bottom, so the classes
+//   come out of the code itself and there is no fixed boundary for a noisy
+//   interval to fall across.  A class of one (a header, or a noisy interval)
+//   is not numbered, so it cannot shift the numbers of the others; it, and
+//   any class after the 8th, count as 8.
+//
+#define HASH_CLASSES  8
+
+static uint8_t  hashClasses (decode_results *results,  int first,
+                             unsigned int lo[],  unsigned int hi[],  uint8_t rank[])
+{
+	uint8_t  n = 0;
+	uint8_t  size[HASH_CLASSES];
+
+	for (int i = first;  i < results->rawlen;  i += 2) {
+		unsigned int  val = results->rawbuf[i];
+		uint8_t       c;
+
+		for (c = 0;  c < n;  c++) {
+			unsigned int  l = (val < lo[c]) ? val : lo[c];
+			unsigned int  h = (val > hi[c]) ? val : hi[c];
+			if ((val >= lo[c] - (lo[c] / 3)) && (val <= hi[c] + (hi[c] >> 1))
+			    && (5UL * h < 8UL * l)) {
+				lo[c] = l;
+				hi[c] = h;
+				size[c]++;
+				break;
+			}
+		}
+		if ((c == n) && (n < HASH_CLASSES))  lo[n] = hi[n] = val,  size[n++] = 1 ;
+	}
+
+	for (uint8_t c = 0;  c < n;  c++) {
+		rank[c] = (size[c] > 1) ? 0 : HASH_CLASSES;
+		for (uint8_t d = 0;  (d < n) && (size[c] > 1);  d++)
+			if ((size[d] > 1) && (lo[d] < lo[c]))  rank[c]++ ;
+	}
+	return n;
+}
+
+//+=============================================================================
+// The class of one interval, as numbered by hashClasses()
+//
+static uint8_t  hashClass (unsigned int val,  uint8_t n,
+                           const unsigned int lo[],  const unsigned int hi[],  const uint8_t rank[])
+{
+	for (uint8_t c = 0;  c < n;  c++)
+		if ((val >= lo[c]) && (val <= hi[c]))  return rank[c] ;
+	return HASH_CLASSES;
 }
+#endif
 
 //+=============================================================================
 // Use FNV hash algorithm: http://isthe.com/chongo/tech/comp/fnv/#FNV-param
@@ -236,20 +1042,81 @@ int  IRrecv::compare (unsigned int oldval,  unsigned int newval)
 
 long  IRrecv::decodeHash (decode_results *results)
 {
-	long  hash = FNV_BASIS_32;
+	unsigned long  hash = FNV_BASIS_32;
 
 	// Require at least 6 samples to prevent triggering on noise
 	if (results->rawlen < 6)  return false ;
 
+#if DECODE_HASH_QUANTIZE
+	// Marks and spaces are classed separately, as receivers tend to stretch
+	//   one and shrink the other
+	unsigned int  lo[2][HASH_CLASSES],  hi[2][HASH_CLASSES];
+	uint8_t       rank[2][HASH_CLASSES],  n[2];
+
+	n[0] = hashClasses(results, 1, lo[0], hi[0], rank[0]);
+	n[1] = hashClasses(results, 2, lo[1], hi[1], rank[1]);
+
+	for (int i = 1;  i < results->rawlen;  i++) {
+		uint8_t  s = !(i & 1);
+		hash = (hash * FNV_PRIME_32) ^ hashClass(results->rawbuf[i], n[s], lo[s], hi[s], rank[s]);
+	}
+#else
 	for (int i = 1;  (i + 2) < results->rawlen;  i++) {
 		int value =  compare(results->rawbuf[i], results->rawbuf[i+2]);
 		// Add value into the hash
 		hash = (hash * FNV_PRIME_32) ^ value;
 	}
+#endif
+
+#if (DECODE_HASH_BITS == 16)
+	hash = ((hash >> 16) ^ hash) & 0xFFFF;  // xor-fold, as FNV suggests
+#endif
 
 	results->value       = hash;
-	results->bits        = 32;
+	results->bits        = DECODE_HASH_BITS;
 	results->decode_type = UNKNOWN;
 
 	return true;
 }
+
+//+=============================================================================
+// Look the hash of an UNKNOWN code up in a table of learned codes
+// The table must be sorted by hash, so this is a binary search
+//
+int  IRrecv::findHash (const decode_results *results,  const hash_action_t table[],  unsigned int count)
+{
+	unsigned int  lo = 0;
+	unsigned int  hi = count;
+
+	if (results->decode_type != UNKNOWN)  return -1 ;
+
+	while (lo < hi) {
+		unsigned int  mid = lo + ((hi - lo) >> 1);
+		if      (table[mid].hash < results->value)  lo = mid + 1 ;
+		else if (table[mid].hash > results->value)  hi = mid ;
+		else                                        return table[mid].action ;
+	}
+	return -1;
+}
+
+//+=============================================================================
+// As findHash(), with the table in flash, eg.
+//   const hash_action_t  learned[] PROGMEM = { { 0x0C8E3F63, 1 }, ... };
+//
+int  IRrecv::findHash_P (const decode_results *results,  const hash_action_t table[],  unsigned int count)
+{
+	unsigned int  lo = 0;
+	unsigned int  hi = count;
+
+	if (results->decode_type != UNKNOWN)  return -1 ;
+
+	while (lo < hi) {
+		unsigned int   mid  = lo + ((hi - lo) >> 1);
+		unsigned long  hash = pgm_read_dword(&table[mid].hash);
+		if      (hash < results->value)  lo = mid + 1 ;
+		else if (hash > results->value)  hi = mid ;
+		else if (sizeof(int) == 2)       return (int)pgm_read_word(&table[mid].action) ;
+		else                             return (int)pgm_read_dword(&table[mid].action) ;
+	}
+	return -1;
+}
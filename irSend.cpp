@@ -1,6 +1,10 @@
 #include "IRremote.h"
 #include "IRremoteInt.h"
 
+#ifndef IR_TIMER_USE_ESP32
+#include <avr/interrupt.h>
+#endif
+
 //+=============================================================================
 void  IRsend::sendRaw (const unsigned int buf[],  unsigned int len,  unsigned int hz)
 {
@@ -15,14 +19,110 @@ void  IRsend::sendRaw (const unsigned int buf[],  unsigned int len,  unsigned in
 	space(0);  // Always end with the LED off
 }
 
+//+=============================================================================
+// sendRaw() with buf in flash, eg.
+//   const unsigned int  power[] PROGMEM = { 9000, 4500, 560, ... };
+//   irsend.sendRaw_P(power, sizeof(power) / sizeof(power[0]), 38);
+//
+void  IRsend::sendRaw_P (const unsigned int buf[],  unsigned int len,  unsigned int hz)
+{
+	enableIROut(hz);
+
+	for (unsigned int i = 0;  i < len;  i++) {
+		unsigned int  usecs = pgm_read_word(&buf[i]);
+		if (i & 1)  space(usecs) ;
+		else        mark (usecs) ;
+	}
+
+	space(0);  // Always end with the LED off
+}
+
+//+=============================================================================
+// sendRaw_P() with each duration packed in to a byte, as a count of
+//   USECPERTICK ticks (the units of decode_results::rawbuf), so 255 ticks
+//   (12.75mS at 50uS) at most.  Half the flash of sendRaw_P().
+//
+void  IRsend::sendRawTicks_P (const uint8_t buf[],  unsigned int len,  unsigned int hz)
+{
+	enableIROut(hz);
+
+	for (unsigned int i = 0;  i < len;  i++) {
+		unsigned int  usecs = pgm_read_byte(&buf[i]) * USECPERTICK;
+		if (i & 1)  space(usecs) ;
+		else        mark (usecs) ;
+	}
+
+	space(0);  // Always end with the LED off
+}
+
+//+=============================================================================
+// Note when the IR LED goes off, for IRrecv::maskEcho()
+// The edge ISR only looks at irtxoff once irtxon is false, so irtxoff is
+//   written first: the ISR can never see it half written (it is 4 bytes, an
+//   AVR writes one at a time), and this also works from the send ISR, where
+//   interrupts must not be turned back on.
+//
+static inline void  irLedOff ( )
+{
+	if (irtxon) {
+		irtxoff = micros();
+		irtxon  = false;
+	}
+}
+
+//+=============================================================================
+// When the mark or space being sent ends, in micros()
+// Each mark and space of a code ends time after the one before it was due to
+//   end, not after whenever mark() or space() got round to starting it.  So
+//   the time the calls and the PWM register writes take does not add up over
+//   a long frame; each edge is as late as the one before, but no later.
+// A code starts the clock at its first mark, and space(0) stops it.
+// Catching up shortens the next mark or space, so it may only take an eighth
+//   of it, which leaves it well within the decoders' tolerance; a code which
+//   has fallen further behind than that (a pause between calls, or a long
+//   interrupt) takes its eighth and drops the rest.
+//
+static unsigned long  tx_deadline = 0;
+static bool           tx_timed    = false;
+
+static void  irWait (unsigned int time)
+{
+	unsigned long  now  = micros();
+	unsigned int   most = time / 8;  // Catch up by at most this much
+
+	if (!tx_timed) {
+		tx_deadline = now;
+		tx_timed    = true;
+	} else if ((long)(now - tx_deadline) > (long)most) {
+		tx_deadline = now - most;
+	}
+	tx_deadline += time;
+
+	while ((long)(micros() - tx_deadline) < 0) ;
+}
+
 //+=============================================================================
 // Sends an IR mark for the specified number of microseconds.
 // The mark output is modulated at the PWM frequency.
 //
 void  IRsend::mark (unsigned int time)
 {
+	if (encoding) {
+		encodeAdd(true, time);
+		return;
+	}
+
+#if SENDBUF
+	if (queueing) {
+		unsigned int  periods = ((unsigned long)time * (queue_carrier.hz / 10) + 50000) / 100000;
+		if (periods)  queueAdd(SEND_MARK | periods) ;
+		return;
+	}
+#endif
+
 	TIMER_ENABLE_PWM; // Enable pin 3 PWM output
-	if (time > 0) custom_delay_usec(time);
+	irtxon = true;
+	if (time > 0) irWait(time);
 }
 
 //+=============================================================================
@@ -32,28 +132,164 @@ void  IRsend::mark (unsigned int time)
 //
 void  IRsend::space (unsigned int time)
 {
+	if (encoding) {
+		encodeAdd(false, time);
+		return;
+	}
+
+#if SENDBUF
+	if (queueing) {
+		unsigned int  periods = ((unsigned long)time * (queue_carrier.hz / 10) + 50000) / 100000;
+		if (periods)  queueAdd(periods) ;
+		return;
+	}
+#endif
+
 	TIMER_DISABLE_PWM; // Disable pin 3 PWM output
-	if (time > 0) IRsend::custom_delay_usec(time);
+	irLedOff();
+	if (time > 0)  irWait(time) ;
+	else           tx_timed = false;  // The end of a code
 }
 
 
 
 
 
+//+=============================================================================
+// The carrier the timer was last set for
+//
+static unsigned long  carrier_hz = 0;
+
+#ifdef TIMER_CONFIG_PWM
+static const uint16_t  carrierPrescalers[] = TIMER_PWM_PRESCALERS;
+
+#	define CARRIER_TOP  ((TIMER_PWM_TOP < 0x7FFF) ? TIMER_PWM_TOP : 0x7FFF)  // Fits a send queue entry
+#endif
+
+//+=============================================================================
+// Work out the timer setting nearest to a carrier of hz, on for duty percent
+// Each prescaler is tried in phase-correct PWM (a period of 2 * TOP clocks)
+//   and in fast PWM (TOP + 1 clocks); on a tie the lowest prescaler wins, as
+//   it sets the duty cycle the most finely
+// If no setting fits, hz comes back 0 with the timer's clock stopped
+//
+static void  irCarrier (unsigned long hz,  uint8_t duty,  ircarrier_t *c)
+{
+#ifdef TIMER_CONFIG_PWM
+	unsigned long  err = ~0UL;
+
+	c->hz      = 0;
+	c->top     = 0;
+	c->compare = 0;
+	c->mode    = 0;  // No clock select
+	if (!hz)  return ;
+	for (uint8_t cs = 0;  cs < sizeof(carrierPrescalers) / sizeof(carrierPrescalers[0]);  cs++) {
+		unsigned long  clk = SYSCLOCK / carrierPrescalers[cs];
+
+		for (uint8_t fast = 0;  fast < 2;  fast++) {
+			unsigned long  div = fast ? (clk + (hz / 2)) / hz : 2 * ((clk + hz) / (2 * hz));  // Clocks per period
+			unsigned long  top = fast ? div - 1 : div / 2;
+			unsigned long  got, off, on;
+
+			if ((top < 2) || (top > CARRIER_TOP))  continue ;
+			got = (clk + (div / 2)) / div;
+			off = (got > hz) ? got - hz : hz - got;
+			if (off >= err)  continue ;
+
+			on         = (div * duty + 50) / 100;  // Clocks on per period
+			err        = off;
+			c->hz      = got;
+			c->top     = top;
+			c->compare = fast ? (on ? on - 1 : 0) : on / 2;
+			c->mode    = (cs + 1) | (fast ? IR_PWM_FAST : 0);
+		}
+	}
+#else
+	c->top = (hz + 500) / 1000;  // For TIMER_CONFIG_KHZ()
+	c->hz  = c->top * 1000UL;
+	(void)duty;
+#endif
+}
+
+//+=============================================================================
+// Set the timer for a carrier
+//
+static inline void  irCarrierSet (uint16_t top,  uint16_t compare,  uint8_t mode)
+{
+#ifdef TIMER_CONFIG_PWM
+	TIMER_CONFIG_PWM(mode & ~IR_PWM_FAST, (mode & IR_PWM_FAST), top, compare);
+#elif defined(TIMER_CONFIG_KHZ)
+	TIMER_CONFIG_KHZ(top);
+	(void)compare;
+	(void)mode;
+#endif
+}
+
 //+=============================================================================
 // Enables IR output.  The khz value controls the modulation frequency in kilohertz.
 // The IR output will be on pin 3 (OC2B).
-// This routine is designed for 36-40KHz; if you use it for other values, it's up to you
-// to make sure it gives reasonable results.  (Watch out for overflow / underflow / rounding.)
-// TIMER2 is used in phase-correct PWM mode, with OCR2A controlling the frequency and OCR2B
-// controlling the duty cycle.
-// There is no prescaling, so the output frequency is 16MHz / (2 * OCR2A)
+// This is enableIROutHz(khz * 1000), with a duty cycle of a third.
+//
+void  IRsend::enableIROut (int khz)
+{
+	enableIROutHz(khz * 1000UL, IR_DUTY_33);
+}
+
+//+=============================================================================
+// Enables IR output with the carrier in Hz, on for duty percent of each period.
+// The timer prescaler, TOP, and phase-correct or fast PWM are chosen to come
+//   as near hz as the timer can; carrierHz() says how near that was.  This
+//   matters for 455kHz (B&O) codes, and on 8MHz boards.
+// TIMER2 is used with OCR2A, the TOP, controlling the frequency and OCR2B
+//   controlling the duty cycle; other timers are alike (see boarddefs.h).
 // To turn the output on and off, we leave the PWM running, but connect and disconnect the output pin.
 // A few hours staring at the ATmega documentation and this will all make sense.
 // See my Secrets of Arduino PWM at http://arcfn.com/2009/07/secrets-of-arduino-pwm.html for details.
 //
-void  IRsend::enableIROut (int khz)
+void  IRsend::enableIROutHz (unsigned long hz,  uint8_t duty)
 {
+	ircarrier_t  c;
+
+	if (encoding) {
+		encode_frame->hz   = hz;
+		encode_frame->duty = duty;
+		return;
+	}
+
+	irCarrier(hz, duty, &c);
+	carrier_hz = c.hz;
+
+#if SENDBUF
+	// Too fast a carrier for the send interrupt: send the code blocking, or if
+	//   some of it is queued already, refuse it
+	if (queueing && (c.hz > SEND_INTR_MAX_HZ)) {
+		if (queue_end == irsendparams.head)  queueing = false ;
+		else                                 queue_ok = false ;
+	}
+
+	if (queueing) {  // The ISR changes the frequency (and emitters) when it gets to this point
+		queueAdd(0);
+		queueAdd(c.top);
+#	ifdef TIMER_CONFIG_PWM
+		queueAdd(c.compare);
+		queueAdd(c.mode);
+#	endif
+		queue_carrier = c;
+#	if IR_GATES
+		queueAdd(0);
+		queueAdd(SEND_MARK | irgates.select);
+#	endif
+		return;
+	}
+
+	// Let any non-blocking send finish before we take over the timer
+	while (isSendBusy()) ;
+#endif
+
+#if IR_GATES
+	irGates(irgates.select);
+#endif
+
 // FIXME: implement ESP32 support, see IR_TIMER_USE_ESP32 in boarddefs.h
 #ifndef ESP32
 	// Disable the Timer2 Interrupt (which is used for receiving IR)
@@ -64,15 +300,24 @@ void  IRsend::enableIROut (int khz)
 
 	// COM2A = 00: disconnect OC2A
 	// COM2B = 00: disconnect OC2B; to send signal set to 10: OC2B non-inverted
-	// WGM2 = 101: phase-correct PWM with OCRA as top
-	// CS2  = 000: no prescaling
-	// The top value for the timer.  The modulation frequency will be SYSCLOCK / 2 / OCR2A.
-	TIMER_CONFIG_KHZ(khz);
+	// WGM2 = 101: phase-correct PWM with OCRA as top, or 111: fast PWM
+	// The modulation frequency will be SYSCLOCK / prescaler / (2 * OCR2A), or / (OCR2A + 1)
+	irCarrierSet(c.top, c.compare, c.mode);
 #endif
 }
 
+//+=============================================================================
+// The carrier frequency the timer gives for the last enableIROut() or
+//   enableIROutHz(), in Hz
+//
+unsigned long  IRsend::carrierHz ( )
+{
+	return carrier_hz;
+}
+
 //+=============================================================================
 // Custom delay function that circumvents Arduino's delayMicroseconds limit
+// mark() and space() no longer use it, see irWait()
 
 void IRsend::custom_delay_usec(unsigned long uSecs) {
   if (uSecs > 4) {
@@ -88,3 +333,388 @@ void IRsend::custom_delay_usec(unsigned long uSecs) {
   //}
 }
 
+#if IR_GATES
+//+=============================================================================
+// Several emitters
+// The carrier from TIMER_PWM_PIN goes to every emitter, and each emitter's
+//   driver only passes it while that emitter's gate pin is high.  So one
+//   sendNEC() (or any other send) goes out on all of the selected emitters
+//   at once, and sendRawMulti() sends a different code on each.
+//
+//+=============================================================================
+// Use these pins, at most IR_GATES of them, as the gates; all are selected
+//
+void  IRsend::gatePins (const uint8_t pins[],  uint8_t count)
+{
+	if (count > IR_GATES)  count = IR_GATES ;
+
+	for (uint8_t i = 0;  i < count;  i++) {
+		irgates.pin[i] = pins[i];
+		pinMode(pins[i], OUTPUT);
+		digitalWrite(pins[i], LOW);
+	}
+	irgates.count  = count;
+	irgates.select = (1 << count) - 1;
+}
+
+//+=============================================================================
+// Emitters the following codes go out on; bit n selects the nth gate pin
+// A code already queued for the send interrupt keeps the emitters it had
+//
+void  IRsend::selectGates (uint8_t mask)
+{
+	irgates.select = mask;
+}
+
+//+=============================================================================
+// Open the gates in mask, and close the others
+// Also called from the send interrupt, as it gets to a code
+//
+void  irGates (uint8_t mask)
+{
+	for (uint8_t i = 0;  i < irgates.count;  i++)
+		digitalWrite(irgates.pin[i], (mask & (1 << i)) ? HIGH : LOW);
+}
+
+//+=============================================================================
+// Send count raw codes at once, bufs[n] (of lens[n] entries, in uS as for
+//   sendRaw()) on the emitter of the nth gate pin.  All share the carrier,
+//   which is on while any of them is in a mark; the gates do the rest.
+// Takes as long as the longest code, rather than all of them one by one.
+//
+bool  IRsend::sendRawMulti (const unsigned int *bufs[],  const unsigned int lens[],
+                            uint8_t count,  unsigned int hz)
+{
+	unsigned int   next[IR_GATES];  // Entry each code is up to
+	unsigned long  ends[IR_GATES];  // micros() when that entry started, then ends
+	uint8_t        gates = 0;
+	bool           pwm   = false;
+
+	if (!count || (count > irgates.count))  return false ;
+
+	enableIROut(hz);
+	irGates(0);
+
+	unsigned long  start = micros();
+	for (uint8_t c = 0;  c < count;  c++)  next[c] = 0,  ends[c] = start ;
+
+	for (;;) {
+		unsigned long  now  = micros();
+		uint8_t        want = 0;
+		bool           live = false;
+
+		for (uint8_t c = 0;  c < count;  c++) {
+			// Step on to the entry this code is in now
+			while ((next[c] < lens[c]) && ((long)(now - ends[c]) >= 0))  ends[c] += bufs[c][next[c]++] ;
+
+			if ((long)(now - ends[c]) < 0) {
+				live = true;
+				if (next[c] & 1)  want |= 1 << c ;  // Entry next[c] - 1 is a mark
+			}
+		}
+		if (!live)  break ;
+
+		// Gates first when a mark starts, carrier first when one ends
+		if (want != gates) {
+			if (want & ~gates)  irGates(want) ;
+			if (want && !pwm)   { TIMER_ENABLE_PWM;  irtxon = true;  pwm = true; }
+			if (!want && pwm)   { TIMER_DISABLE_PWM;  irLedOff();  pwm = false; }
+			if (~want & gates)  irGates(want) ;
+			gates = want;
+		}
+	}
+
+	space(0);  // Always end with the LED off
+	irGates(irgates.select);
+	return true;
+}
+#endif // IR_GATES
+
+//+=============================================================================
+// Non-blocking sends
+// sendRawAsync(), sendNECAsync() & co. run the normal send code, but with
+//   enableIROut(), mark() and space() adding to irsendparams.buf instead of
+//   driving the LED.  The send interrupt comes once per carrier period and
+//   counts off the periods of each mark and space; so a code with a carrier
+//   above SEND_INTR_MAX_HZ is sent blocking instead (see enableIROutHz()).
+// As with the blocking sends, the timer is not receiving while it sends:
+//   call enableIRIn() again once isSendBusy() is false.
+// If the timer has no send interrupt (see boarddefs.h) the codes are sent
+//   straight away, blocking as usual.
+//
+#if SENDBUF
+
+#ifdef TIMER_SEND_INTR_NAME
+ISR (TIMER_SEND_INTR_NAME)
+{
+	unsigned int  entry;
+
+	// Nearly every interrupt just counts off another carrier period
+	if (irsendparams.left > 1) {
+		irsendparams.left--;
+		return;
+	}
+
+	while (irsendparams.tail != irsendparams.head) {
+		entry = irsendparams.buf[irsendparams.tail];
+		if (++irsendparams.tail >= SENDBUF)  irsendparams.tail = 0 ;
+
+		if (entry & SEND_MARK) {
+			TIMER_ENABLE_PWM;
+			irtxon            = true;
+			irsendparams.left = entry & ~SEND_MARK;
+			return;
+		}
+
+		TIMER_DISABLE_PWM;
+		irLedOff();
+		if (entry) {
+			irsendparams.left = entry;
+			return;
+		}
+
+		// A new carrier frequency, the emitters to use, or the end of a code
+		entry = irsendparams.buf[irsendparams.tail];
+		if (++irsendparams.tail >= SENDBUF)  irsendparams.tail = 0 ;
+
+#	if IR_GATES
+		if      (entry & SEND_MARK)  irGates(entry & 0xFF) ;
+		else
+#	endif
+		if      (entry) {
+#	ifdef TIMER_CONFIG_PWM
+			unsigned int  compare = irsendparams.buf[irsendparams.tail];
+			if (++irsendparams.tail >= SENDBUF)  irsendparams.tail = 0 ;
+			unsigned int  mode    = irsendparams.buf[irsendparams.tail];
+			if (++irsendparams.tail >= SENDBUF)  irsendparams.tail = 0 ;
+			irCarrierSet(entry, compare, mode);
+#	else
+			irCarrierSet(entry, 0, 0);
+#	endif
+		}
+		else if (irsendparams.done)  irsendparams.done() ;
+	}
+
+	// Nothing left to send
+	TIMER_DISABLE_SEND_INTR;
+	irsendparams.busy = false;
+}
+#endif
+
+//+=============================================================================
+// Start queueing a code
+//
+void  IRsend::queueBegin ( )
+{
+#ifdef TIMER_SEND_INTR_NAME
+	queueing  = true;
+	queue_ok  = true;
+	queue_end = irsendparams.head;
+	queue_carrier.hz = 0;
+#endif
+}
+
+//+=============================================================================
+// Add an entry to the code being queued
+// The ISR cannot see it until queueEnd() moves irsendparams.head
+//
+void  IRsend::queueAdd (unsigned int entry)
+{
+	uint8_t  next = (queue_end + 1 < SENDBUF) ? queue_end + 1 : 0;
+
+	if (next == irsendparams.tail)  queue_ok = false ;  // Queue full
+	if (!queue_ok)                  return ;
+
+	irsendparams.buf[queue_end] = entry;
+	queue_end                   = next;
+}
+
+//+=============================================================================
+// Hand the queued code to the ISR, and start it if it is not running
+// Returns false (and drops the code) if the code did not fit
+//
+bool  IRsend::queueEnd ( )
+{
+	if (!queueing) {  // It has already been sent
+		if (irsendparams.done)  irsendparams.done() ;
+		return true;
+	}
+
+	queueAdd(0);  // End of code
+	queueAdd(0);
+	queueing = false;
+
+	if (!queue_ok || !queue_carrier.hz)  return false ;
+
+#ifdef TIMER_SEND_INTR_NAME
+	noInterrupts();
+	irsendparams.head = queue_end;
+	if (!irsendparams.busy) {
+		TIMER_DISABLE_INTR;  // The receive interrupt
+		pinMode(TIMER_PWM_PIN, OUTPUT);
+		digitalWrite(TIMER_PWM_PIN, LOW);
+		irCarrierSet(queue_carrier.top, queue_carrier.compare, queue_carrier.mode);
+
+		irsendparams.left = 1;  // Start on the next interrupt
+		irsendparams.busy = true;
+		TIMER_ENABLE_SEND_INTR;
+	}
+	interrupts();
+#endif
+
+	return true;
+}
+
+//+=============================================================================
+// Queue a raw code; see sendRaw()
+//
+bool  IRsend::sendRawAsync (const unsigned int buf[],  unsigned int len,  unsigned int hz)
+{
+	queueBegin();
+	sendRaw(buf, len, hz);
+	return queueEnd();
+}
+
+//+=============================================================================
+// Queue a sequence of rendered codes; see sendSequence()
+// The whole sequence, gaps and all, must fit in the room left in the queue, or
+//   none of it is queued and it returns false.  Each code takes its len
+//   entries, 4 for its carrier (2 without TIMER_CONFIG_PWM, 2 more with
+//   IR_GATES) and 1 for each 65mS of the gap after it, and the sequence 2 to
+//   end it: 73 for one NEC code, 145 for two, so they need a SENDBUF of 160.
+//
+#ifdef TIMER_CONFIG_PWM
+#	define QUEUE_CARRIER  (4 + (IR_GATES ? 2 : 0))  // Entries for a new carrier
+#else
+#	define QUEUE_CARRIER  (2 + (IR_GATES ? 2 : 0))
+#endif
+
+bool  IRsend::sendSequenceAsync (const IRframe frames[],  unsigned int count)
+{
+#ifdef TIMER_SEND_INTR_NAME  // Otherwise it is sent straight away, blocking
+	unsigned int   used = (irsendparams.head + SENDBUF - irsendparams.tail) % SENDBUF;
+	unsigned long  need = 2;  // The end of the code
+
+	for (unsigned int n = 0;  n < count;  n++) {
+		need += QUEUE_CARRIER + frames[n].len;
+		if ((n + 1) < count)  need += (frames[n].gap + 0xFFFE) / 0xFFFF ;  // As sendSequence() splits it
+	}
+	if (need > SENDBUF - 1 - used)  return false ;  // The ISR only ever makes more room
+#endif
+
+	queueBegin();
+	sendSequence(frames, count);
+	return queueEnd();
+}
+
+//+=============================================================================
+// true while there are queued codes still being sent
+//
+bool  IRsend::isSendBusy ( )
+{
+	return irsendparams.busy;
+}
+
+//+=============================================================================
+// Have callback called (from the ISR, so keep it short!) after each code is sent
+//
+void  IRsend::onSendDone (void (*callback)(void))
+{
+	irsendparams.done = callback;
+}
+
+#endif // SENDBUF
+
+//+=============================================================================
+// Codes rendered ahead of time
+// encode() (IRremote.h) runs the normal send code, but with enableIROut(),
+//   mark() and space() writing the marks & spaces to a buffer, as for
+//   sendRaw(), instead of driving the LED.  sendSequence() then sends any
+//   number of them one after another, with nothing left to work out between
+//   the marks.
+// Each frame keeps the gap to leave after it: the rest of the protocol's
+//   repeat period where its send sets encode_period (NEC's 108mS, from the
+//   start of one frame to the next), or else IR_FRAME_GAP.
+//
+
+//+=============================================================================
+// Start rendering a code into buf, of size entries
+//
+void  IRsend::encodeBegin (IRframe *frame,  unsigned int *buf,  unsigned int size)
+{
+	frame->hz     = 0;
+	frame->duty   = IR_DUTY_33;
+	frame->len    = 0;
+	frame->gap    = IR_FRAME_GAP;
+	frame->data   = buf;
+	encode_frame  = frame;
+	encode_period = 0;
+	encode_size   = size;
+	encode_ok     = true;
+	encoding      = true;
+}
+
+//+=============================================================================
+// Add a mark or space to the code being rendered
+// Two marks (or spaces) in a row, as bi-phase codes send, make one longer one
+//
+void  IRsend::encodeAdd (bool mark,  unsigned int time)
+{
+	IRframe  *f = encode_frame;
+
+	if (!time)                               return ;
+	if (!f->len && !mark)                    return ;  // A code starts with a mark
+
+	if (f->len && ((f->len & 1) == mark)) {            // The same as the last one
+		unsigned long  sum = (unsigned long)f->data[f->len - 1] + time;
+		f->data[f->len - 1] = (sum > 0xFFFF) ? 0xFFFF : sum;
+		return;
+	}
+
+	if (f->len >= encode_size)  encode_ok = false ;
+	else                        f->data[f->len++] = time ;
+}
+
+//+=============================================================================
+// Finish rendering a code
+// Returns false if the code did not fit
+//
+bool  IRsend::encodeEnd ( )
+{
+	IRframe        *f      = encode_frame;
+	unsigned long   length = 0;
+
+	encoding = false;
+	if (!encode_ok || !f->len || !f->hz)  return false ;
+
+	for (unsigned int i = 0;  i < f->len;  i++)  length += f->data[i] ;
+	if (encode_period > length + _GAP)  f->gap = encode_period - length ;
+	return true;
+}
+
+//+=============================================================================
+// Send count rendered codes one after another, with each one's gap after it
+//
+void  IRsend::sendSequence (const IRframe frames[],  unsigned int count)
+{
+	for (unsigned int n = 0;  n < count;  n++) {
+		const IRframe  *f = &frames[n];
+
+		enableIROutHz(f->hz, f->duty);
+		for (unsigned int i = 0;  i < f->len;  i++) {
+			if (i & 1)  space(f->data[i]) ;
+			else        mark (f->data[i]) ;
+		}
+
+		// The gap, in pieces if it is longer than space() can take
+		if ((n + 1) < count) {
+			for (unsigned long  gap = f->gap;  gap;  ) {
+				unsigned int  time = (gap > 0xFFFF) ? 0xFFFF : gap;
+				space(time);
+				gap -= time;
+			}
+		}
+	}
+
+	space(0);  // Always end with the LED off
+}
@@ -0,0 +1,177 @@
+//******************************************************************************
+// IRremote
+// Version 2.0.1 June, 2015
+// Copyright 2009 Ken Shirriff
+// For details, see http://arcfn.com/2009/08/multi-protocol-infrared-remote-library.html
+
+// The timings of the protocols whose decoders candidates(), irEarlyEnd() and
+// keyRepeat() (irRecv.cpp) must agree with.  They were in the ir_XXX.cpp
+// files; they are here so those tests can use the same numbers.
+// All times are in uS
+//******************************************************************************
+
+#ifndef irtimings_h
+#define irtimings_h
+
+//------------------------------------------------------------------------------
+// NEC (ir_NEC.cpp)
+//
+#define NEC_BITS          32
+#define NEC_HDR_MARK    9000
+#define NEC_HDR_SPACE   4500
+#define NEC_BIT_MARK     560
+#define NEC_ONE_SPACE   1690
+#define NEC_ZERO_SPACE   560
+#define NEC_RPT_SPACE   2250
+#define NEC_RPT_LENGTH  108000  // From the start of one frame to the next
+
+//------------------------------------------------------------------------------
+// Sony (ir_Sony.cpp)
+//
+#define SONY_BITS                   12
+#define SONY_HDR_MARK             2400
+#define SONY_HDR_SPACE             600
+#define SONY_ONE_MARK             1200
+#define SONY_ZERO_MARK             600
+#define SONY_RPT_LENGTH          45000
+#define SONY_DOUBLE_SPACE_USECS  25000  // leading gap below this means a repeat frame
+
+//------------------------------------------------------------------------------
+// Sanyo (ir_Sanyo.cpp)
+//
+#define SANYO_BITS                   12
+#define SANYO_HDR_MARK	           3500  // seen range 3500
+#define SANYO_HDR_SPACE	            950  // seen 950
+#define SANYO_ONE_MARK	           2400  // seen 2400
+#define SANYO_ZERO_MARK             700  // seen 700
+#define SANYO_DOUBLE_SPACE_USECS  40000  // leading gap below this means a repeat frame
+#define SANYO_RPT_LENGTH          45000
+
+//------------------------------------------------------------------------------
+// Mitsubishi (ir_Mitsubishi.cpp)
+//
+#define MITSUBISHI_BITS 16
+
+// Mitsubishi RM 75501
+// 14200 7 41 7 42 7 42 7 17 7 17 7 18 7 41 7 18 7 17 7 17 7 18 7 41 8 17 7 17 7 18 7 17 7
+// #define MITSUBISHI_HDR_MARK	250  // seen range 3500
+#define MITSUBISHI_HDR_SPACE	350 //  7*50+100
+#define MITSUBISHI_ONE_MARK	1950 // 41*50-100
+#define MITSUBISHI_ZERO_MARK  750 // 17*50-100
+// #define MITSUBISHI_DOUBLE_SPACE_USECS  800  // usually ssee 713 - not using ticks as get number wrapround
+// #define MITSUBISHI_RPT_LENGTH 45000
+
+//------------------------------------------------------------------------------
+// RC5 (ir_RC5_RC6.cpp)
+//
+#define MIN_RC5_SAMPLES     11
+#define RC5_T1             889
+// A frame is sent every 64 bit times of 1.778mS (Philips RC5), from the start
+//   of one to the next; only encode() uses it
+#define RC5_RPT_LENGTH  113778
+
+//------------------------------------------------------------------------------
+// RC6 (ir_RC5_RC6.cpp)
+//
+#define MIN_RC6_SAMPLES      1
+#define RC6_HDR_MARK      2666
+#define RC6_HDR_SPACE      889
+#define RC6_T1             444
+// A frame is sent every 240 units of 444uS (Philips RC6 mode 0), from the start
+//   of one to the next; only encode() uses it
+#define RC6_RPT_LENGTH  106667
+
+//------------------------------------------------------------------------------
+// Panasonic (ir_Panasonic.cpp)
+//
+#define PANASONIC_BITS          48
+#define PANASONIC_HDR_MARK    3502
+#define PANASONIC_HDR_SPACE   1750
+#define PANASONIC_BIT_MARK     502
+#define PANASONIC_ONE_SPACE   1244
+#define PANASONIC_ZERO_SPACE   400
+
+//------------------------------------------------------------------------------
+// LG (ir_LG.cpp)
+//
+#define LG_BITS 28
+
+#define LG_HDR_MARK 8000
+#define LG_HDR_SPACE 4000
+#define LG_BIT_MARK 600
+#define LG_ONE_SPACE 1600
+#define LG_ZERO_SPACE 550
+#define LG_RPT_LENGTH 60000
+
+//------------------------------------------------------------------------------
+// JVC (ir_JVC.cpp)
+//
+#define JVC_BITS           16
+#define JVC_HDR_MARK     8000
+#define JVC_HDR_SPACE    4000
+#define JVC_BIT_MARK      600
+#define JVC_ONE_SPACE    1600
+#define JVC_ZERO_SPACE    550
+#define JVC_RPT_LENGTH  60000
+
+//------------------------------------------------------------------------------
+// Samsung (ir_Samsung.cpp)
+//
+#define SAMSUNG_BITS          32
+#define SAMSUNG_HDR_MARK    5000
+#define SAMSUNG_HDR_SPACE   5000
+#define SAMSUNG_BIT_MARK     560
+#define SAMSUNG_ONE_SPACE   1600
+#define SAMSUNG_ZERO_SPACE   560
+#define SAMSUNG_RPT_SPACE   2250
+#define SAMSUNG_RPT_LENGTH  108000  // From the start of one frame to the next
+
+//------------------------------------------------------------------------------
+// Whynter (ir_Whynter.cpp)
+//
+#define WHYNTER_BITS          32
+#define WHYNTER_HDR_MARK    2850
+#define WHYNTER_HDR_SPACE   2850
+#define WHYNTER_BIT_MARK     750
+#define WHYNTER_ONE_MARK     750
+#define WHYNTER_ONE_SPACE   2150
+#define WHYNTER_ZERO_MARK    750
+#define WHYNTER_ZERO_SPACE   750
+
+//------------------------------------------------------------------------------
+// Aiwa RC-T501 (ir_Aiwa.cpp)
+//
+#define AIWA_RC_T501_HZ            38
+#define AIWA_RC_T501_BITS          15
+#define AIWA_RC_T501_PRE_BITS      26
+#define AIWA_RC_T501_POST_BITS      1
+#define AIWA_RC_T501_SUM_BITS    (AIWA_RC_T501_PRE_BITS + AIWA_RC_T501_BITS + AIWA_RC_T501_POST_BITS)
+#define AIWA_RC_T501_HDR_MARK    8800
+#define AIWA_RC_T501_HDR_SPACE   4500
+#define AIWA_RC_T501_BIT_MARK     500
+#define AIWA_RC_T501_ONE_SPACE    600
+#define AIWA_RC_T501_ZERO_SPACE  1700
+
+//------------------------------------------------------------------------------
+// Denon (ir_Denon.cpp)
+//
+#define DENON_BITS          14  // The number of bits in the command
+
+#define DENON_HDR_MARK     300  // The length of the Header:Mark
+#define DENON_HDR_SPACE    750  // The lenght of the Header:Space
+
+#define DENON_BIT_MARK     300  // The length of a Bit:Mark
+#define DENON_ONE_SPACE   1800  // The length of a Bit:Space for 1's
+#define DENON_ZERO_SPACE   750  // The length of a Bit:Space for 0's
+
+//------------------------------------------------------------------------------
+// rStep (ir_rStep.cpp)
+//
+#define RSTEP_SHORT_PULSE_38k		315	/* µsec, burst 200..460µsec, gap 160..430µsec  */
+#define RSTEP_LONG_PULSE_38k		630	/* µsec, burst 520..780µsec, gap 470..750µsec  */
+#define RSTEP_SHORT_PULSE_56k		213	/* µsec, burst 140..320µsec, gap 100..290µsec  */
+#define RSTEP_LONG_PULSE_56k		426	/* µsec, burst 350..540µsec, gap 320..500µsec  */
+#define RSTEP_FIRST_MARK_MIN		100	/* µsec, a first MARK of either rate as received,  */
+#define RSTEP_FIRST_MARK_MAX		850	/* µsec, with room to spare, for candidates()  */
+
+#endif
@@ -12,16 +12,7 @@
 // Based off the RC-T501 RCU
 // Lirc file http://lirc.sourceforge.net/remotes/aiwa/RC-T501
 
-#define AIWA_RC_T501_HZ            38
-#define AIWA_RC_T501_BITS          15
-#define AIWA_RC_T501_PRE_BITS      26
-#define AIWA_RC_T501_POST_BITS      1
-#define AIWA_RC_T501_SUM_BITS    (AIWA_RC_T501_PRE_BITS + AIWA_RC_T501_BITS + AIWA_RC_T501_POST_BITS)
-#define AIWA_RC_T501_HDR_MARK    8800
-#define AIWA_RC_T501_HDR_SPACE   4500
-#define AIWA_RC_T501_BIT_MARK     500
-#define AIWA_RC_T501_ONE_SPACE    600
-#define AIWA_RC_T501_ZERO_SPACE  1700
+// The Aiwa RC-T501 timings (AIWA_RC_T501_...) are in irTimings.h
 
 //+=============================================================================
 #if SEND_AIWA_RC_T501
@@ -77,14 +68,14 @@ bool  IRrecv::decodeAiwaRCT501 (decode_results *results)
 	int  offset = 1;
 
 	// Check SIZE
-	if (irparams.rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
+	if (results->rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
 
 	// Check HDR Mark/Space
 	if (!MATCH_MARK (results->rawbuf[offset++], AIWA_RC_T501_HDR_MARK ))  return false ;
 	if (!MATCH_SPACE(results->rawbuf[offset++], AIWA_RC_T501_HDR_SPACE))  return false ;
 
 	offset += 26;  // skip pre-data - optional
-	while(offset < irparams.rawlen - 4) {
+	while(offset < results->rawlen - 4) {
 		if (MATCH_MARK(results->rawbuf[offset], AIWA_RC_T501_BIT_MARK))  offset++ ;
 		else                                                             return false ;
 
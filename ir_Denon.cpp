@@ -19,41 +19,27 @@
 //                    DDDD   EEEEE  N   N   OOO   N   N
 //==============================================================================
 
-#define BITS          14  // The number of bits in the command
+// The Denon timings (DENON_...) are in irTimings.h
 
-#define HDR_MARK     300  // The length of the Header:Mark
-#define HDR_SPACE    750  // The lenght of the Header:Space
-
-#define BIT_MARK     300  // The length of a Bit:Mark
-#define ONE_SPACE   1800  // The length of a Bit:Space for 1's
-#define ZERO_SPACE   750  // The length of a Bit:Space for 0's
+//+=============================================================================
+// The timings, for sendProtocol() and decodeProtocol()
+//
+#if (SEND_DENON || DECODE_DENON)
+static const ir_protocol_t  DENON_PROTOCOL PROGMEM = IR_PROTOCOL(
+	DENON, 38, DENON_BITS, IR_PROTO_EXACT_LEN,
+	DENON_HDR_MARK, DENON_HDR_SPACE,
+	DENON_BIT_MARK, DENON_ONE_SPACE, DENON_ZERO_SPACE,
+	DENON_BIT_MARK,                  // Footer
+	0, 0
+);
+#endif
 
 //+=============================================================================
 //
 #if SEND_DENON
 void  IRsend::sendDenon (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark (HDR_MARK);
-	space(HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark (BIT_MARK);
-			space(ONE_SPACE);
-		} else {
-			mark (BIT_MARK);
-			space(ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendProtocol(&DENON_PROTOCOL, data, nbits);
 }
 #endif
 
@@ -62,33 +48,6 @@ void  IRsend::sendDenon (unsigned long data,  int nbits)
 #if DECODE_DENON
 bool  IRrecv::decodeDenon (decode_results *results)
 {
-	unsigned long  data   = 0;  // Somewhere to build our code
-	int            offset = 1;  // Skip the Gap reading
-
-	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
-
-	// Check initial Mark+Space match
-	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], HDR_SPACE))  return false ;
-
-	// Read the bits in
-	for (int i = 0;  i < BITS;  i++) {
-		// Each bit looks like: MARK + SPACE_1 -> 1
-		//                 or : MARK + SPACE_0 -> 0
-		if (!MATCH_MARK(results->rawbuf[offset++], BIT_MARK))  return false ;
-
-		// IR data is big-endian, so we shuffle it in from the right:
-		if      (MATCH_SPACE(results->rawbuf[offset], ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                        return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = BITS;
-	results->value       = data;
-	results->decode_type = DENON;
-	return true;
+	return decodeProtocol(results, &DENON_PROTOCOL);
 }
 #endif
@@ -39,8 +39,108 @@ void IRsend::sendLegoPowerFunctions(uint16_t data, bool repeat)
   bitStreamEncoder.reset(data, repeat);
   do {
     mark(bitStreamEncoder.getMarkDuration());
-    space(bitStreamEncoder.getPauseDuration());
+    // The pauses between repeats are longer than space() can take in one go
+    uint32_t pause = bitStreamEncoder.getPauseDuration();
+    for (; pause > 0xFFFF; pause -= 0xFFFF) {
+      space(0xFFFF);
+    }
+    space(pause);
   } while (bitStreamEncoder.next());
 }
 
+//+=============================================================================
+// Sending to several channels at once
+// A message is sent five times, at set times after the first (see
+//   LegoPfBitStreamEncoder::getRepeatInterval()), which differ by channel so
+//   that the four channels' transmissions interleave rather than collide.
+// scheduleLegoPowerFunctions() hands a message to its channel; a new message
+//   for a channel takes over from the one it had, in that one's next slot.
+//   runLegoPowerFunctions() sends whichever transmission is due, one at a
+//   time; with SENDBUF it queues it and returns straight away, otherwise
+//   it blocks for the one transmission (16mS at most), but never for the
+//   repeats in between.
+//
+namespace {
+struct LegoPfChannel {
+  uint16_t data;
+  uint8_t sent;           // Transmissions of data so far
+  bool active;            // Still some of data to send
+  unsigned long due;      // micros() when the next transmission may start
+};
+
+LegoPfChannel legoPfChannels[4];
+// micros() when the last transmission started; as if a whole message time
+// before boot, so that the first one need not wait
+unsigned long legoPfLast = 0UL - LegoPfBitStreamEncoder::MAX_MESSAGE_LENGTH;
+} // anonymous namespace
+
+void IRsend::scheduleLegoPowerFunctions(uint16_t data)
+{
+  static LegoPfBitStreamEncoder bitStreamEncoder;
+  bitStreamEncoder.reset(data, false);
+  LegoPfChannel& channel = legoPfChannels[bitStreamEncoder.getChannelId() - 1];
+
+  // An idle channel may start again once its last repeat interval is over
+  unsigned long now = micros();
+  if (!channel.active && (long)(now - channel.due) > 0) {
+    channel.due = now;
+  }
+  channel.data = data;
+  channel.sent = 0;
+  channel.active = true;
+}
+
+// Call this often; returns false once every channel has sent all it had
+bool IRsend::runLegoPowerFunctions()
+{
+#if SENDBUF
+  if (isSendBusy()) {
+    return true;  // Whatever is on the air has to finish first
+  }
+#endif
+
+  // The channel which has been waiting longest for its slot, but no sooner
+  // than a whole message time after the last transmission on any channel
+  unsigned long now = micros();
+  bool clear = now - legoPfLast >= LegoPfBitStreamEncoder::MAX_MESSAGE_LENGTH;
+  LegoPfChannel* next = NULL;
+  bool active = false;
+  for (uint8_t i = 0; i < 4; i++) {
+    LegoPfChannel& channel = legoPfChannels[i];
+    if (!channel.active) {
+      continue;
+    }
+    active = true;
+    if (clear && (long)(now - channel.due) >= 0
+        && (!next || (long)(next->due - channel.due) > 0)) {
+      next = &channel;
+    }
+  }
+  if (!next) {
+    return active;
+  }
+
+#if SENDBUF
+  queueBegin();
+  sendLegoPowerFunctions(next->data, false);
+  if (!queueEnd()) {
+    // Nothing was queued.  Try again next call if the queue has codes in it;
+    // if it is empty, SENDBUF cannot hold a message, so send it blocking.
+    if (isSendBusy()) {
+      return true;
+    }
+    sendLegoPowerFunctions(next->data, false);
+  }
+#else
+  sendLegoPowerFunctions(next->data, false);
+#endif
+
+  // The next repeat is timed from when this one really started
+  int channelId = 1 + (next - legoPfChannels);
+  next->due = now + LegoPfBitStreamEncoder::getRepeatInterval(channelId, next->sent < 4 ? next->sent : 3);
+  next->active = ++next->sent < 5;
+  legoPfLast = now;
+  return true;
+}
+
 #endif // SEND_LEGO_PF
@@ -43,6 +43,16 @@ class LegoPfBitStreamEncoder {
 
   int getChannelId() const { return 1 + ((data >> 12) & 0x3); }
 
+  // Time from the start of a repeated message to the start of its next
+  // repeat, after the first (repeatCount 0) to fourth (3) of the five
+  static uint32_t getRepeatInterval(int channelId, uint8_t repeatCount) {
+    if (repeatCount < 2) {
+      return (uint32_t)5 * MAX_MESSAGE_LENGTH;
+    } else {
+      return (uint32_t)(6 + 2 * channelId) * MAX_MESSAGE_LENGTH;
+    }
+  }
+
   uint16_t getMessageLength() const {
     // Sum up all marks
     uint16_t length = MESSAGE_BITS * IR_MARK_DURATION;
@@ -103,11 +113,8 @@ class LegoPfBitStreamEncoder {
   }
 
   uint32_t getRepeatStopPause() const {
-    if (repeatCount == 0 || repeatCount == 1) {
-      return STOP_PAUSE_DURATION + (uint32_t)5 * MAX_MESSAGE_LENGTH - messageLength;
-    } else if (repeatCount == 2 || repeatCount == 3) {
-      return STOP_PAUSE_DURATION
-             + (uint32_t)(6 + 2 * getChannelId()) * MAX_MESSAGE_LENGTH - messageLength;
+    if (repeatCount < 4) {
+      return STOP_PAUSE_DURATION + getRepeatInterval(getChannelId(), repeatCount) - messageLength;
     } else {
       return STOP_PAUSE_DURATION;
     }
@@ -11,24 +11,15 @@
 
 // Looks like Sony except for timings, 48 chars of data and time/space different
 
-#define MITSUBISHI_BITS 16
-
-// Mitsubishi RM 75501
-// 14200 7 41 7 42 7 42 7 17 7 17 7 18 7 41 7 18 7 17 7 17 7 18 7 41 8 17 7 17 7 18 7 17 7
-// #define MITSUBISHI_HDR_MARK	250  // seen range 3500
-#define MITSUBISHI_HDR_SPACE	350 //  7*50+100
-#define MITSUBISHI_ONE_MARK	1950 // 41*50-100
-#define MITSUBISHI_ZERO_MARK  750 // 17*50-100
-// #define MITSUBISHI_DOUBLE_SPACE_USECS  800  // usually ssee 713 - not using ticks as get number wrapround
-// #define MITSUBISHI_RPT_LENGTH 45000
+// The Mitsubishi timings (MITSUBISHI_...) are in irTimings.h
 
 //+=============================================================================
 #if DECODE_MITSUBISHI
 bool  IRrecv::decodeMitsubishi (decode_results *results)
 {
-  // Serial.print("?!? decoding Mitsubishi:");Serial.print(irparams.rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
+  // Serial.print("?!? decoding Mitsubishi:");Serial.print(results->rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
   long data = 0;
-  if (irparams.rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
+  if (results->rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
   int offset = 0; // Skip first space
   // Initial space
 
@@ -60,7 +51,7 @@ bool  IRrecv::decodeMitsubishi (decode_results *results)
   if (!MATCH_MARK(results->rawbuf[offset], MITSUBISHI_HDR_SPACE))  return false ;
   offset++;
 
-  while (offset + 1 < irparams.rawlen) {
+  while (offset + 1 < results->rawlen) {
     if      (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ONE_MARK))   data = (data << 1) | 1 ;
     else if (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ZERO_MARK))  data <<= 1 ;
     else                                                                 return false ;
@@ -9,39 +9,38 @@
 //                           N   N  EEEEE   CCCC
 //==============================================================================
 
-#define NEC_BITS          32
-#define NEC_HDR_MARK    9000
-#define NEC_HDR_SPACE   4500
-#define NEC_BIT_MARK     560
-#define NEC_ONE_SPACE   1690
-#define NEC_ZERO_SPACE   560
-#define NEC_RPT_SPACE   2250
+// The NEC timings (NEC_...) are in irTimings.h
+
+//+=============================================================================
+// The timings, for sendProtocol() and decodeProtocol()
+//
+#if (SEND_NEC || DECODE_NEC)
+static const ir_protocol_t  NEC_PROTOCOL PROGMEM = IR_PROTOCOL(
+	NEC, 38, NEC_BITS, 0,
+	NEC_HDR_MARK, NEC_HDR_SPACE,
+	NEC_BIT_MARK, NEC_ONE_SPACE, NEC_ZERO_SPACE,
+	NEC_BIT_MARK,                    // Footer
+	NEC_RPT_SPACE, NEC_RPT_LENGTH
+);
+#endif
 
 //+=============================================================================
 #if SEND_NEC
 void  IRsend::sendNEC (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(NEC_HDR_MARK);
-	space(NEC_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(NEC_BIT_MARK);
-			space(NEC_ONE_SPACE);
-		} else {
-			mark(NEC_BIT_MARK);
-			space(NEC_ZERO_SPACE);
-		}
-	}
+	sendProtocol(&NEC_PROTOCOL, data, nbits);
+}
+#endif
 
-	// Footer
-	mark(NEC_BIT_MARK);
-	space(0);  // Always end with the LED off
+//+=============================================================================
+// Queue an NEC code and return straight away; see sendRawAsync()
+//
+#if (SEND_NEC && SENDBUF)
+bool  IRsend::sendNECAsync (unsigned long data,  int nbits)
+{
+	queueBegin();
+	sendNEC(data, nbits);
+	return queueEnd();
 }
 #endif
 
@@ -51,48 +50,6 @@ void  IRsend::sendNEC (unsigned long data,  int nbits)
 #if DECODE_NEC
 bool  IRrecv::decodeNEC (decode_results *results)
 {
-	long  data   = 0;  // We decode in to here; Start with nothing
-	int   offset = 1;  // Index in to results; Skip first entry!?
-
-	// Check header "mark"
-	if (!MATCH_MARK(results->rawbuf[offset], NEC_HDR_MARK))  return false ;
-	offset++;
-
-	// Check for repeat
-	if ( (irparams.rawlen == 4)
-	    && MATCH_SPACE(results->rawbuf[offset  ], NEC_RPT_SPACE)
-	    && MATCH_MARK (results->rawbuf[offset+1], NEC_BIT_MARK )
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = NEC;
-		return true;
-	}
-
-	// Check we have enough data
-	if (irparams.rawlen < (2 * NEC_BITS) + 4)  return false ;
-
-	// Check header "space"
-	if (!MATCH_SPACE(results->rawbuf[offset], NEC_HDR_SPACE))  return false ;
-	offset++;
-
-	// Build the data
-	for (int i = 0;  i < NEC_BITS;  i++) {
-		// Check data "mark"
-		if (!MATCH_MARK(results->rawbuf[offset], NEC_BIT_MARK))  return false ;
-		offset++;
-        // Suppend this bit
-		if      (MATCH_SPACE(results->rawbuf[offset], NEC_ONE_SPACE ))  data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], NEC_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = NEC_BITS;
-	results->value       = data;
-	results->decode_type = NEC;
-
-	return true;
+	return decodeProtocol(results, &NEC_PROTOCOL);
 }
 #endif
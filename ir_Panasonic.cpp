@@ -9,12 +9,7 @@
 //       P      A   A  N   N  A   A  SSSS    OOO   N   N  IIIII   CCCC
 //==============================================================================
 
-#define PANASONIC_BITS          48
-#define PANASONIC_HDR_MARK    3502
-#define PANASONIC_HDR_SPACE   1750
-#define PANASONIC_BIT_MARK     502
-#define PANASONIC_ONE_SPACE   1244
-#define PANASONIC_ZERO_SPACE   400
+// The Panasonic timings (PANASONIC_...) are in irTimings.h
 
 //+=============================================================================
 #if SEND_PANASONIC
@@ -49,16 +49,15 @@ int  IRrecv::getRClevel (decode_results *results,  int *offset,  int *used,  int
 //
 // NB: First bit must be a one (start bit)
 //
-#define MIN_RC5_SAMPLES     11
-#define RC5_T1             889
-#define RC5_RPT_LENGTH   46000
+// The RC5 and RC6 timings (RC5_..., RC6_...) are in irTimings.h
 
 //+=============================================================================
 #if SEND_RC5
 void  IRsend::sendRC5 (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
+	// Set IR carrier frequency, and the repeat period for encode()
 	enableIROut(36);
+	encode_period = RC5_RPT_LENGTH;
 
 	// Start
 	mark(RC5_T1);
@@ -89,14 +88,14 @@ bool  IRrecv::decodeRC5 (decode_results *results)
 	int   used   = 0;
 	int   offset = 1;  // Skip gap space
 
-	if (irparams.rawlen < MIN_RC5_SAMPLES + 2)  return false ;
+	if (results->rawlen < MIN_RC5_SAMPLES + 2)  return false ;
 
 	// Get start bits
 	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
 	if (getRClevel(results, &offset, &used, RC5_T1) != SPACE)  return false ;
 	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
 
-	for (nbits = 0;  offset < irparams.rawlen;  nbits++) {
+	for (nbits = 0;  offset < results->rawlen;  nbits++) {
 		int  levelA = getRClevel(results, &offset, &used, RC5_T1);
 		int  levelB = getRClevel(results, &offset, &used, RC5_T1);
 
@@ -122,17 +121,12 @@ bool  IRrecv::decodeRC5 (decode_results *results)
 //
 // NB : Caller needs to take care of flipping the toggle bit
 //
-#define MIN_RC6_SAMPLES      1
-#define RC6_HDR_MARK      2666
-#define RC6_HDR_SPACE      889
-#define RC6_T1             444
-#define RC6_RPT_LENGTH   46000
-
 #if SEND_RC6
 void  IRsend::sendRC6 (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
+	// Set IR carrier frequency, and the repeat period for encode()
 	enableIROut(36);
+	encode_period = RC6_RPT_LENGTH;
 
 	// Header
 	mark(RC6_HDR_MARK);
@@ -9,39 +9,26 @@
 //             SSSS   A   A  M   M  SSSS    UUU   N   N   GGG
 //==============================================================================
 
-#define SAMSUNG_BITS          32
-#define SAMSUNG_HDR_MARK    5000
-#define SAMSUNG_HDR_SPACE   5000
-#define SAMSUNG_BIT_MARK     560
-#define SAMSUNG_ONE_SPACE   1600
-#define SAMSUNG_ZERO_SPACE   560
-#define SAMSUNG_RPT_SPACE   2250
+// The Samsung timings (SAMSUNG_...) are in irTimings.h
+
+//+=============================================================================
+// The timings, for sendProtocol() and decodeProtocol()
+//
+#if (SEND_SAMSUNG || DECODE_SAMSUNG)
+static const ir_protocol_t  SAMSUNG_PROTOCOL PROGMEM = IR_PROTOCOL(
+	SAMSUNG, 38, SAMSUNG_BITS, 0,
+	SAMSUNG_HDR_MARK, SAMSUNG_HDR_SPACE,
+	SAMSUNG_BIT_MARK, SAMSUNG_ONE_SPACE, SAMSUNG_ZERO_SPACE,
+	SAMSUNG_BIT_MARK,                // Footer
+	SAMSUNG_RPT_SPACE, SAMSUNG_RPT_LENGTH
+);
+#endif
 
 //+=============================================================================
 #if SEND_SAMSUNG
 void  IRsend::sendSAMSUNG (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(SAMSUNG_HDR_MARK);
-	space(SAMSUNG_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ONE_SPACE);
-		} else {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(SAMSUNG_BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendProtocol(&SAMSUNG_PROTOCOL, data, nbits);
 }
 #endif
 
@@ -51,42 +38,7 @@ void  IRsend::sendSAMSUNG (unsigned long data,  int nbits)
 #if DECODE_SAMSUNG
 bool  IRrecv::decodeSAMSUNG (decode_results *results)
 {
-	long  data   = 0;
-	int   offset = 1;  // Skip first space
-
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset], SAMSUNG_HDR_MARK))   return false ;
-	offset++;
-
-	// Check for repeat
-	if (    (irparams.rawlen == 4)
-	     && MATCH_SPACE(results->rawbuf[offset], SAMSUNG_RPT_SPACE)
-	     && MATCH_MARK(results->rawbuf[offset+1], SAMSUNG_BIT_MARK)
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = SAMSUNG;
-		return true;
-	}
-	if (irparams.rawlen < (2 * SAMSUNG_BITS) + 4)  return false ;
-
-	// Initial space
-	if (!MATCH_SPACE(results->rawbuf[offset++], SAMSUNG_HDR_SPACE))  return false ;
-
-	for (int i = 0;  i < SAMSUNG_BITS;   i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], SAMSUNG_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                                return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = SAMSUNG_BITS;
-	results->value       = data;
-	results->decode_type = SAMSUNG;
-	return true;
+	return decodeProtocol(results, &SAMSUNG_PROTOCOL);
 }
 #endif
 
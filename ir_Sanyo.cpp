@@ -12,22 +12,16 @@
 // I think this is a Sanyo decoder:  Serial = SA 8650B
 // Looks like Sony except for timings, 48 chars of data and time/space different
 
-#define SANYO_BITS                   12
-#define SANYO_HDR_MARK	           3500  // seen range 3500
-#define SANYO_HDR_SPACE	            950  // seen 950
-#define SANYO_ONE_MARK	           2400  // seen 2400
-#define SANYO_ZERO_MARK             700  // seen 700
-#define SANYO_DOUBLE_SPACE_USECS    800  // usually ssee 713 - not using ticks as get number wrapround
-#define SANYO_RPT_LENGTH          45000
+// The Sanyo timings (SANYO_...) are in irTimings.h
 
 //+=============================================================================
 #if DECODE_SANYO
 bool  IRrecv::decodeSanyo (decode_results *results)
 {
-	long  data   = 0;
-	int   offset = 0;  // Skip first space  <-- CHECK THIS!
+	unsigned long  data   = 0;
+	int            offset = 0;  // Skip first space  <-- CHECK THIS!
 
-	if (irparams.rawlen < (2 * SANYO_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SANYO_BITS) + 2)  return false ;
 
 #if 0
 	// Put this back in for debugging - note can't use #DEBUG as if Debug on we don't see the repeat cos of the delay
@@ -38,7 +32,7 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 #endif
 
 	// Initial space
-	if (results->rawbuf[offset] < SANYO_DOUBLE_SPACE_USECS) {
+	if (results->rawbuf[offset] < SANYO_DOUBLE_SPACE_USECS / USECPERTICK) {
 		//Serial.print("IR Gap found: ");
 		results->bits        = 0;
 		results->value       = REPEAT;
@@ -53,14 +47,8 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 	// Skip Second Mark
 	if (!MATCH_MARK(results->rawbuf[offset++], SANYO_HDR_MARK))  return false ;
 
-	while (offset + 1 < irparams.rawlen) {
-		if (!MATCH_SPACE(results->rawbuf[offset++], SANYO_HDR_SPACE))  break ;
-
-		if      (MATCH_MARK(results->rawbuf[offset], SANYO_ONE_MARK))   data = (data << 1) | 1 ;
-		else if (MATCH_MARK(results->rawbuf[offset], SANYO_ZERO_MARK))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
+	const bit_timing_t  bit = PULSE_WIDTH(SANYO_HDR_SPACE, SANYO_ONE_MARK, SANYO_ZERO_MARK);
+	if (!decodePulseWidth(results, &offset, &bit, &data))  return false ;
 
 	// Success
 	results->bits = (offset - 1) / 2;
@@ -9,37 +9,27 @@
 //                          SSSS    OOO   N   N    Y
 //==============================================================================
 
-#define SONY_BITS                   12
-#define SONY_HDR_MARK             2400
-#define SONY_HDR_SPACE             600
-#define SONY_ONE_MARK             1200
-#define SONY_ZERO_MARK             600
-#define SONY_RPT_LENGTH          45000
-#define SONY_DOUBLE_SPACE_USECS    500  // usually ssee 713 - not using ticks as get number wrapround
+// The Sony timings (SONY_...) are in irTimings.h
+
+//+=============================================================================
+// The timings, for sendProtocol()
+// decodeSony() is its own: it takes 12, 15 or 20 bits, and spots fast repeats
+//
+#if SEND_SONY
+static const ir_protocol_t  SONY_PROTOCOL PROGMEM = IR_PROTOCOL(
+	SONY, 40, SONY_BITS, IR_PROTO_PULSE_WIDTH,
+	SONY_HDR_MARK, 0,                // The header space is the first bit's
+	SONY_HDR_SPACE, SONY_ONE_MARK, SONY_ZERO_MARK,
+	0,                               // No footer
+	0, SONY_RPT_LENGTH
+);
+#endif
 
 //+=============================================================================
 #if SEND_SONY
 void  IRsend::sendSony (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(40);
-
-	// Header
-	mark(SONY_HDR_MARK);
-	space(SONY_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SONY_ONE_MARK);
-			space(SONY_HDR_SPACE);
-		} else {
-			mark(SONY_ZERO_MARK);
-			space(SONY_HDR_SPACE);
-    	}
-  	}
-
-	// We will have ended with LED off
+	sendProtocol(&SONY_PROTOCOL, data, nbits);
 }
 #endif
 
@@ -47,14 +37,14 @@ void  IRsend::sendSony (unsigned long data,  int nbits)
 #if DECODE_SONY
 bool  IRrecv::decodeSony (decode_results *results)
 {
-	long  data   = 0;
-	int   offset = 0;  // Dont skip first space, check its size
+	unsigned long  data   = 0;
+	int            offset = 0;  // Dont skip first space, check its size
 
-	if (irparams.rawlen < (2 * SONY_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SONY_BITS) + 2)  return false ;
 
 	// Some Sony's deliver repeats fast after first
 	// unfortunately can't spot difference from of repeat from two fast clicks
-	if (results->rawbuf[offset] < SONY_DOUBLE_SPACE_USECS) {
+	if (results->rawbuf[offset] < SONY_DOUBLE_SPACE_USECS / USECPERTICK) {
 		// Serial.print("IR Gap found: ");
 		results->bits = 0;
 		results->value = REPEAT;
@@ -72,14 +62,8 @@ bool  IRrecv::decodeSony (decode_results *results)
 	// Initial mark
 	if (!MATCH_MARK(results->rawbuf[offset++], SONY_HDR_MARK))  return false ;
 
-	while (offset + 1 < irparams.rawlen) {
-		if (!MATCH_SPACE(results->rawbuf[offset++], SONY_HDR_SPACE))  break ;
-
-		if      (MATCH_MARK(results->rawbuf[offset], SONY_ONE_MARK))   data = (data << 1) | 1 ;
-		else if (MATCH_MARK(results->rawbuf[offset], SONY_ZERO_MARK))  data = (data << 1) | 0 ;
-		else                                                           return false ;
-		offset++;
-	}
+	const bit_timing_t  bit = PULSE_WIDTH(SONY_HDR_SPACE, SONY_ONE_MARK, SONY_ZERO_MARK);
+	if (!decodePulseWidth(results, &offset, &bit, &data))  return false ;
 
 	// Success
 	results->bits = (offset - 1) / 2;
@@ -19,13 +19,18 @@ Now we can start to add our new protocol...
 
 2. Replace all occurrences of "Shuzu" with the name of your protocol.
 
-3. Tweak the #defines to suit your protocol.
+3. Tweak the #defines, and the flags in SHUZU_PROTOCOL, to suit your protocol.
 
-4. If you're lucky, tweaking the #defines will make the default send() function
-   work.
+4. If you're lucky, it is a pulse distance or pulse width code (most are), and
+   that is all: sendProtocol() and decodeProtocol() (irProtocol.cpp) will send
+   and decode it from the timings in SHUZU_PROTOCOL.
 
-5. Again, if you're lucky, tweaking the #defines will have made the default
-   decode() function work.
+5. If it isn't, you will have to write your own send() and decode() functions;
+   ir_RC5_RC6.cpp and decodeSony() in ir_Sony.cpp show how.
+
+If you only need the protocol in your own sketch, you can stop here: put an
+ir_protocol_t in the sketch and call sendProtocol() and decodeProtocol() with
+it, as the IRprotocolTable example does.
 
 You have written the code to support your new protocol!
 
@@ -58,13 +63,23 @@ Now you must do a few things to add it to the IRremote system:
 
 2. Now open irRecv.cpp and make the following change:
 
-   A. In the function IRrecv::decode(), add:
-      #ifdef DECODE_NEC
-          DBG_PRINTLN("Attempting Shuzu decode");
-          if (decodeShuzu(results))  return true ;
+   A. In the function IRrecv::candidates(), add a quick test which your
+      decoder also makes, using the same timings (eg. length & header mark):
+      #if DECODE_SHUZU
+          if ((len == 1 + 2 + (2 * 32) + 1) && MARK_IS(1000))  cand |= CANDIDATE(SHUZU) ;
+      #endif
+      If you cannot think of one, just set the bit:
+          cand |= CANDIDATE(SHUZU);
+
+   B. In the function IRrecv::decode(), add:
+      #if DECODE_SHUZU
+          if (cand & CANDIDATE(SHUZU)) {
+              DBG_PRINTLN("Attempting Shuzu decode");
+              if (decodeShuzu(results))  return true ;
+          }
       #endif
 
-   B. Save your changes and close the file
+   C. Save your changes and close the file
 
 You will probably want to add your new protocol to the example sketch
 
@@ -113,32 +128,26 @@ Regards,
 
 #define OTHER       1234  // Other things you may need to define
 
+//+=============================================================================
+// The timings, for sendProtocol() and decodeProtocol()
+// See IRremote.h for the flags: IR_PROTO_PULSE_WIDTH, IR_PROTO_LSB_FIRST, ...
+//
+#if (SEND_SHUZU || DECODE_SHUZU)
+static const ir_protocol_t  SHUZU_PROTOCOL PROGMEM = IR_PROTOCOL(
+	SHUZU, 38, BITS, IR_PROTO_EXACT_LEN,
+	HDR_MARK, HDR_SPACE,
+	BIT_MARK, ONE_SPACE, ZERO_SPACE,
+	BIT_MARK,                        // Footer
+	0, 0                             // No repeat code; no set repeat period
+);
+#endif
+
 //+=============================================================================
 //
 #if SEND_SHUZU
 void  IRsend::sendShuzu (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark (HDR_MARK);
-	space(HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark (BIT_MARK);
-			space(ONE_SPACE);
-		} else {
-			mark (BIT_MARK);
-			space(ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendProtocol(&SHUZU_PROTOCOL, data, nbits);
 }
 #endif
 
@@ -147,33 +156,6 @@ void  IRsend::sendShuzu (unsigned long data,  int nbits)
 #if DECODE_SHUZU
 bool  IRrecv::decodeShuzu (decode_results *results)
 {
-	unsigned long  data   = 0;  // Somewhere to build our code
-	int            offset = 1;  // Skip the Gap reading
-
-	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
-
-	// Check initial Mark+Space match
-	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], HDR_SPACE))  return false ;
-
-	// Read the bits in
-	for (int i = 0;  i < SHUZU_BITS;  i++) {
-		// Each bit looks like: MARK + SPACE_1 -> 1
-		//                 or : MARK + SPACE_0 -> 0
-		if (!MATCH_MARK(results->rawbuf[offset++], BIT_MARK))  return false ;
-
-		// IR data is big-endian, so we shuffle it in from the right:
-		if      (MATCH_SPACE(results->rawbuf[offset], ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                        return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = BITS;
-	results->value       = data;
-	results->decode_type = SHUZU;
-	return true;
+	return decodeProtocol(results, &SHUZU_PROTOCOL);
 }
 #endif
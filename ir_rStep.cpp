@@ -38,58 +38,173 @@
 //   STA=1       |            Cust=1101                              |  Addr=01                |  Frametype=10           |  Bat=1     |   Data = 00011110
 
 
+/* The rStep pulse lengths (RSTEP_..._PULSE_...) are in irTimings.h  */
+
+#define RSTEP_ADDRESS_BITS		9	/* Customer ID (4), Address (2), Frametype (2), Battery (1)  */
+
 //+=============================================================================
 //
 #if SEND_RSTEP
-#error "Not yet implemented."
+
+/* Append one half bit (a short pulse of level) to the frame being sent.
+   Halves of the same level run together, and are sent as one MARK or SPACE
+   when the level changes.  */
+static void
+sendRstepHalf (IRsend &irsend, bool &mark, unsigned int &run,
+               bool level, unsigned int pulse)
+{
+	if (run && level != mark) {
+		if (mark)
+			irsend.mark (run);
+		else
+			irsend.space (run);
+		run = 0;
+	}
+	mark = level;
+	run += pulse;
+}
+
+/* Bi-phase: 1 is MARK -> SPACE, 0 is SPACE -> MARK.  */
+static void
+sendRstepBits (IRsend &irsend, bool &mark, unsigned int &run,
+               unsigned long bits, int nbits, unsigned int pulse)
+{
+	for (unsigned long mask = 1UL << (nbits - 1); mask; mask >>= 1) {
+		bool one = !! (bits & mask);
+
+		sendRstepHalf (irsend, mark, run, one, pulse);
+		sendRstepHalf (irsend, mark, run, ! one, pulse);
+	}
+}
+
+void IRsend::sendRstep (unsigned int address, unsigned long data, int nbits, int khz) {
+	unsigned int pulse = (khz == 56)? RSTEP_SHORT_PULSE_56k: RSTEP_SHORT_PULSE_38k;
+	bool mark = true;
+	unsigned int run = 0;
+
+	enableIROut ((khz == 56)? 56: 38);
+
+	/* Start bit, then the address bits as decodeRstep() returns them
+	   and the data, all high-bits first.  */
+	sendRstepBits (*this, mark, run, 1, 1, pulse);
+	sendRstepBits (*this, mark, run, address, RSTEP_ADDRESS_BITS, pulse);
+	sendRstepBits (*this, mark, run, data, nbits, pulse);
+
+	if (mark)
+		this->mark (run);
+	space (0);	/* Always end with the LED off.  */
+}
 #endif /* SEND_RSTEP  */
 
 //+=============================================================================
 //
 #if DECODE_RSTEP
 
-static bool decodeRstepInternal (decode_results *results,
-                                 unsigned int short_min, unsigned int short_max,
-                                 unsigned int long_min,  unsigned int long_max);
+/* Short and long pulses are told apart by these windows, [lo..hi) µsec,
+   converted to (inclusive) counts of the current sample tick.  MARKs and
+   SPACEs have windows of their own, as the receiver stretches the MARKs
+   (by anything up to about MARK_EXCESS) and shortens the SPACEs by as
+   much.  The split between short and long is midway between the longest
+   short and the shortest long pulse as they may be received; a count of
+   ticks up to the split is short, beyond it is long.  */
+#define RSTEP_MIN_TICKS(us)		((us) / USECPERTICK)
+#define RSTEP_MAX_TICKS(us)		((us) / USECPERTICK - 1)
+#define RSTEP_SHORT_TICKS(split)	((split) / USECPERTICK)
+#define RSTEP_LONG_TICKS(split)		((split) / USECPERTICK + 1)
 
-#define RSTEP_SHORT_PULSE_38k		315	/* µsec, burst 200..460µsec, gap 160..430µsec  */
-#define RSTEP_LONG_PULSE_38k		630	/* µsec, burst 520..780µsec, gap 470..750µsec  */
-#define RSTEP_SHORT_PULSE_56k		213	/* µsec, burst 140..320µsec, gap 100..290µsec  */
-#define RSTEP_LONG_PULSE_56k		426	/* µsec, burst 350..540µsec, gap 320..500µsec  */
+#define RSTEP_MARK_SPLIT(pulse)		((3 * (pulse) + MARK_EXCESS) / 2)
+#define RSTEP_SPACE_SPLIT(pulse)	((3 * (pulse) - MARK_EXCESS) / 2)
 
-#define RSTEP_SHORT_PULSE_38k_MIN_TICKS	4	/* 50µsec ticks  */
-#define RSTEP_SHORT_PULSE_38k_MAX_TICKS	10	/* 50µsec ticks  */
-#define RSTEP_LONG_PULSE_38k_MIN_TICKS	11	/* 50µsec ticks  */
-#define RSTEP_LONG_PULSE_38k_MAX_TICKS	16	/* 50µsec ticks  */
+typedef struct {
+	unsigned int short_min, short_max;
+	unsigned int long_min,  long_max;
+} rstep_window_t;
 
-#define RSTEP_SHORT_PULSE_56k_MIN_TICKS	2	/* 50µsec ticks  */
-#define RSTEP_SHORT_PULSE_56k_MAX_TICKS	6	/* 50µsec ticks  */
-#define RSTEP_LONG_PULSE_56k_MIN_TICKS	7	/* 50µsec ticks  */
-#define RSTEP_LONG_PULSE_56k_MAX_TICKS	11	/* 50µsec ticks  */
+typedef struct {
+	rstep_window_t mark;
+	rstep_window_t space;
+} rstep_timing_t;
 
-bool IRrecv::decodeRstep (decode_results *results) {
-	/* 38kHz is more common, try that first. If that was unsuccessful,
-	   try 56kHz, which is less common, but around in the field.  */
-	if (decodeRstepInternal (results,
-	                         RSTEP_SHORT_PULSE_38k_MIN_TICKS, RSTEP_SHORT_PULSE_38k_MAX_TICKS,
-	                         RSTEP_LONG_PULSE_38k_MIN_TICKS,  RSTEP_LONG_PULSE_38k_MAX_TICKS)
-	    || decodeRstepInternal (results,
-	                            RSTEP_SHORT_PULSE_56k_MIN_TICKS, RSTEP_SHORT_PULSE_56k_MAX_TICKS,
-	                            RSTEP_LONG_PULSE_56k_MIN_TICKS,  RSTEP_LONG_PULSE_56k_MAX_TICKS))
-		return true;
-
-	return false;
-}
+#define RSTEP_MARK_SPLIT_38k		RSTEP_MARK_SPLIT(RSTEP_SHORT_PULSE_38k)
+#define RSTEP_SPACE_SPLIT_38k		RSTEP_SPACE_SPLIT(RSTEP_SHORT_PULSE_38k)
+#define RSTEP_MARK_SPLIT_56k		RSTEP_MARK_SPLIT(RSTEP_SHORT_PULSE_56k)
+#define RSTEP_SPACE_SPLIT_56k		RSTEP_SPACE_SPLIT(RSTEP_SHORT_PULSE_56k)
 
-static bool
-decodeRstepInternal (decode_results *results,
-                     unsigned int short_min_ticks, unsigned int short_max_ticks,
-	             unsigned int long_min_ticks,  unsigned int long_max_ticks)
+static const rstep_timing_t rstep_38k = {
+	{ RSTEP_MIN_TICKS(200), RSTEP_SHORT_TICKS(RSTEP_MARK_SPLIT_38k),
+	  RSTEP_LONG_TICKS(RSTEP_MARK_SPLIT_38k), RSTEP_MAX_TICKS(900) },
+	{ RSTEP_MIN_TICKS( 50), RSTEP_SHORT_TICKS(RSTEP_SPACE_SPLIT_38k),
+	  RSTEP_LONG_TICKS(RSTEP_SPACE_SPLIT_38k), RSTEP_MAX_TICKS(850) },
+};
+
+static const rstep_timing_t rstep_56k = {
+	{ RSTEP_MIN_TICKS(100), RSTEP_SHORT_TICKS(RSTEP_MARK_SPLIT_56k),
+	  RSTEP_LONG_TICKS(RSTEP_MARK_SPLIT_56k), RSTEP_MAX_TICKS(650) },
+	{ RSTEP_MIN_TICKS( 50), RSTEP_SHORT_TICKS(RSTEP_SPACE_SPLIT_56k),
+	  RSTEP_LONG_TICKS(RSTEP_SPACE_SPLIT_56k), RSTEP_MAX_TICKS(600) },
+};
+
+/* The first MARK is always one short pulse (the start bit is a 1), and
+   picks the rate: a 56kHz one is 213..313µsec as received, a 38kHz one
+   315..415µsec, so split them at 314µsec.  Below the split, it can only be
+   56kHz.  Above it, the tick count of a stretched 56kHz MARK can get there
+   too, so the frame is cut up at both rates (see decodeRstep()).  */
+#define RSTEP_38k_FIRST_MARK_MIN_TICKS	\
+	RSTEP_MIN_TICKS((RSTEP_SHORT_PULSE_56k + RSTEP_SHORT_PULSE_38k + MARK_EXCESS) / 2)
+
+/* One rate's view of the frame, as Part I of the decode cuts it up.  */
+typedef struct {
+	const rstep_timing_t *timing;
+	bool ok;			/* Every MARK and SPACE so far fits this rate.  */
+	bool all_short;			/* ... and all of them were short pulses.  */
+	uint64_t real_biphase_bits;	/* Bi-phase bits separated to individual time-based bits.  */
+	int num_real_biphase_bits;
+} rstep_walk_t;
+
+/* Part I, for one MARK or SPACE: cut it into individual bits, each
+   representing the state in one unit of time.  */
+static void
+rstepCut (rstep_walk_t *walk, int i, unsigned int ticks)
 {
-	uint64_t real_biphase_bits = 0;	/* Bi-phase bits separated to individual time-based bits.  */
-	uint64_t real_data_bits = 0;	/* Data bits after bi-phase dissection.  */
-	int num_real_biphase_bits = 0;
-	int num_real_data_bits = 0;
+	bool mark = (i % 2 == 1);	/* Uneven bit number: MARK bit; even: SPACE bit.  */
+	const rstep_window_t *w = mark? &walk->timing->mark: &walk->timing->space;
+	int units;
+
+	if (ticks >= w->short_min && ticks <= w->short_max)
+		units = 1;
+	else if (ticks >= w->long_min && ticks <= w->long_max)
+		units = 2;
+	else {
+		DBG_PRINT ("rawbuf[");
+		DBG_PRINT (i);
+		DBG_PRINTLN (mark? "] seems to not be a mark of proper length."
+		                 : "] seems to not be a space of proper length.");
+		walk->ok = false;
+		return;
+	}
+	if (units == 2)
+		walk->all_short = false;
+
+	/* The bit mask is zero-initialized, so a SPACE only has to be counted.  */
+	while (units--) {
+		if (mark)
+			walk->real_biphase_bits |= 1ULL << walk->num_real_biphase_bits;
+		walk->num_real_biphase_bits++;
+	}
+}
+
+static bool rstepData (decode_results *results, uint64_t real_biphase_bits, int num_real_biphase_bits);
+
+/* A 56kHz frame whose MARKs are stretched by most of MARK_EXCESS looks like
+   38kHz by its first MARK, and then every MARK and SPACE of it is short at
+   38kHz: it would decode as all ones.  So a frame which is all short pulses
+   at 38kHz is taken at 56kHz first.  (A real 38kHz frame of all ones does
+   not fit 56kHz, where its SPACEs are long.)
+   Both rates are cut up in the one walk over rawbuf; only the dissection of
+   the bits is done again if the first rate's fails.  */
+bool IRrecv::decodeRstep (decode_results *results) {
+	if (results->rawlen < 2)
+		return false;
 
 #if DEBUG
 	char buf[10];
@@ -108,40 +223,33 @@ decodeRstepInternal (decode_results *results,
 	DBG_PRINTLN ("");
 #endif /* DEBUG  */
 
-	/* Part I: Cut those short and long MARKs and SPACEs into individual
-	   bits, each representing the state in one unit of time.  */
-	for (int i = 1; i < results->rawlen; i++) {
-		if (i % 2 == 1)		{	/* Uneven bit number: MARK bit.  */
-			if (results->rawbuf[i] >= short_min_ticks
-			    && results->rawbuf[i] <= short_max_ticks) {
-				real_biphase_bits |= 1ULL << num_real_biphase_bits++;
-			} else if (results->rawbuf[i] >= long_min_ticks
-			           && results->rawbuf[i] <= long_max_ticks) {
-				real_biphase_bits |= 1ULL << num_real_biphase_bits++;
-				real_biphase_bits |= 1ULL << num_real_biphase_bits++;
-			} else {
-				DBG_PRINT ("rawbuf[");
-				DBG_PRINT (i);
-				DBG_PRINTLN ("] seems to not be a mark of proper length.");
-				return false;
-			}
-		} else { /* if (i % 2 == 0) */		/* Even rawbuf: SPACE bit.  */
-			if (results->rawbuf[i] >= short_min_ticks
-			    && results->rawbuf[i] <= short_max_ticks) {
-				real_biphase_bits |= 0ULL << num_real_biphase_bits++;
-			} else if (results->rawbuf[i] >= long_min_ticks
-			           && results->rawbuf[i] <= long_max_ticks) {
-				real_biphase_bits |= 0ULL << num_real_biphase_bits++;
-				real_biphase_bits |= 0ULL << num_real_biphase_bits++;
-			} else {
-				DBG_PRINT ("rawbuf[");
-				DBG_PRINT (i);
-				DBG_PRINTLN ("] seems to not be a space of proper length.");
-				return false;
-			}
-		}
+	/* Below the split, the first MARK can only be 56kHz.  */
+	rstep_walk_t at38k = { &rstep_38k, results->rawbuf[1] >= RSTEP_38k_FIRST_MARK_MIN_TICKS, true, 0, 0 };
+	rstep_walk_t at56k = { &rstep_56k, true, true, 0, 0 };
+
+	for (int i = 1; i < results->rawlen && (at38k.ok || at56k.ok); i++) {
+		unsigned int ticks = results->rawbuf[i];
+
+		if (at38k.ok)
+			rstepCut (&at38k, i, ticks);
+		if (at56k.ok)
+			rstepCut (&at56k, i, ticks);
 	}
 
+	const rstep_walk_t *first = at38k.all_short? &at56k: &at38k;
+	const rstep_walk_t *second = at38k.all_short? &at38k: &at56k;
+
+	return (first->ok && rstepData (results, first->real_biphase_bits, first->num_real_biphase_bits))
+	    || (second->ok && rstepData (results, second->real_biphase_bits, second->num_real_biphase_bits));
+}
+
+/* Parts II and III: the data bits from the bi-phase bits, into results.  */
+static bool
+rstepData (decode_results *results, uint64_t real_biphase_bits, int num_real_biphase_bits)
+{
+	uint64_t real_data_bits = 0;	/* Data bits after bi-phase dissection.  */
+	int num_real_data_bits = 0;
+
 	/* Part II: If the bit count is uneven and ends in a MARK, we didn't
 	   see the SPACE, so simply add 1 to the bit count. Note that the bit
 	   mask is zero-initialized and thus contains a proper SPACE value.  */
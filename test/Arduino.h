@@ -0,0 +1,127 @@
+//******************************************************************************
+// IRremote host tests
+// Just enough of the Arduino core, and of an ATmega328's timer 2, to build the
+//   library on a PC.  Time only passes when the library asks for it (micros(),
+//   delay(), ...) or a test calls simIdle(); see sim.cpp.
+//******************************************************************************
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+typedef bool     boolean;
+typedef uint8_t  byte;
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        1
+#define FALLING       2
+#define RISING        3
+#define DEC          10
+#define HEX          16
+
+#define F_CPU  16000000UL
+
+//------------------------------------------------------------------------------
+// Flash is just memory
+//
+#define PROGMEM
+#define PGM_P                 const char *
+#define pgm_read_byte(a)      (*(const uint8_t *)(a))
+inline uint16_t  pgm_read_word  (const void *a)  { uint16_t  w;  memcpy(&w, a, sizeof(w));  return w; }
+#define pgm_read_ptr(a)       (*(void * const *)(a))
+inline uint32_t  pgm_read_dword (const void *a)  { uint32_t  d;  memcpy(&d, a, sizeof(d));  return d; }
+#define memcpy_P(d, s, n)     memcpy((d), (s), (n))
+#define F(s)                  (s)
+class __FlashStringHelper;
+
+//------------------------------------------------------------------------------
+// Timer 2, the port registers and the bits of them the library uses
+//
+extern volatile uint8_t  TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+extern volatile uint8_t  PORTB, PINB, PORTD, PIND, EIFR, SREG;
+
+#define _BV(b)         (1 << (b))
+#define _SFR_BYTE(s)   (s)
+#define WGM20   0
+#define WGM21   1
+#define WGM22   3
+#define CS20    0
+#define CS21    1
+#define CS22    2
+#define COM2B1  5
+#define COM2A0  6
+#define OCIE2A  1
+#define OCF2A   1
+#define TOIE2   0
+#define TOV2    0
+
+#define B00000001  0x01
+#define B00100000  0x20
+#define B01111111  0x7F
+#define B10000000  0x80
+#define B11011111  0xDF
+#define B11111110  0xFE
+
+#define ISR(vector)  extern "C" void vector (void)
+
+//------------------------------------------------------------------------------
+// Time, pins and interrupts
+//
+unsigned long  micros ( ) ;
+unsigned long  millis ( ) ;
+void           delay  (unsigned long ms) ;
+void           delayMicroseconds (unsigned int us) ;
+
+int   digitalRead  (uint8_t pin) ;
+void  digitalWrite (uint8_t pin,  uint8_t val) ;
+void  pinMode      (uint8_t pin,  uint8_t mode) ;
+
+#define NOT_A_PIN                0
+#define NOT_AN_INTERRUPT        -1
+#define digitalPinToInterrupt(p) (((p) == 2 || (p) == 3) ? (p) - 2 : NOT_AN_INTERRUPT)
+#define digitalPinToPort(p)      ((p) < 8 ? 4 : 2)
+#define digitalPinToBitMask(p)   ((uint8_t)(1 << ((p) & 7)))
+#define portInputRegister(P)     ((P) == 4 ? &PIND : &PINB)
+#define portOutputRegister(P)    ((P) == 4 ? &PORTD : &PORTB)
+
+void  attachInterrupt (int num,  void (*isr)(void),  int mode) ;
+void  detachInterrupt (int num) ;
+
+// There is only the one thread, so these have nothing to do
+inline void  cli          ( )  { }
+inline void  sei          ( )  { }
+inline void  noInterrupts ( )  { }
+inline void  interrupts   ( )  { }
+
+//------------------------------------------------------------------------------
+// Serial prints to stdout when simSerial is set
+//
+extern bool  simSerial;
+
+struct HostSerial
+{
+	void  begin     (long)  { }
+	int   available ( )     { return 0; }
+	int   read      ( )     { return -1; }
+
+	template <class T>  void  print   (T v)       { if (simSerial)  std::cout << v ; }
+	template <class T>  void  print   (T v, int)  { if (simSerial)  std::cout << std::hex << v << std::dec ; }
+	template <class T>  void  println (T v)       { if (simSerial)  std::cout << v << "\n" ; }
+	template <class T>  void  println (T v, int)  { if (simSerial)  std::cout << std::hex << v << std::dec << "\n" ; }
+	void                      println ( )         { if (simSerial)  std::cout << "\n" ; }
+
+	operator bool ( )  { return true; }
+};
+
+extern HostSerial  Serial;
+
+#endif
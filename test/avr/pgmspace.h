@@ -0,0 +1 @@
+// IRremote host tests: Arduino.h (the one in test/) has all of this
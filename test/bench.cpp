@@ -0,0 +1,205 @@
+//******************************************************************************
+// IRremote host tests
+// The IRbenchmark example, on the PC: how fast, and how reliably, decode()
+//   works.  Frames of each protocol are made up, with timing jitter and the
+//   odd glitch, and handed straight to decode().
+// For each protocol it prints the frames decoded correctly, and the mean and
+//   worst time decode() took, in nS of this machine; only compare the times
+//   with another run on the same machine.  The frames are the same each run,
+//   and it fails if any protocol decodes fewer of them than it did when its
+//   minGood was set.
+//******************************************************************************
+
+#include <chrono>
+#include "sim.h"
+
+#define FRAMES     2000  // Frames of each protocol
+#define JITTER       10  // Each mark & space is off by up to this many percent
+#define NOISE         5  // Out of 100 frames, how many have a glitch in a mark
+
+IRrecv          irrecv(2);  // Never enabled: the frames go in with simFrame()
+decode_results  results;
+
+// The shape of each protocol's frames
+#define PDIST   0  // Pulse distance: bits are the space after each mark
+#define PWIDTH  1  // Pulse width: bits are the length of the mark (Sony)
+#define BIRC5   2  // Bi-phase (RC5)
+#define BIRC6   3  // Bi-phase with a header and a double width trailer bit (RC6)
+#define NOISY   4  // Random marks & spaces, which should come out UNKNOWN
+
+static const struct {
+	const char    *name;
+	int            type;
+	uint8_t        shape;
+	unsigned int   hdrMark, hdrSpace, bitMark, one, zero;
+	uint8_t        bits;
+	unsigned long  fixed;    // Value to send, for protocols with a check; 0 for random
+	uint8_t        minGood;  // Percent of frames which must decode
+}
+protos[] = {
+	{ "NEC",       NEC,       PDIST,  9000, 4500,  560, 1690,  560, 32, 0,          93 },
+	{ "Samsung",   SAMSUNG,   PDIST,  5000, 5000,  560, 1600,  560, 32, 0,          92 },
+	{ "JVC",       JVC,       PDIST,  8000, 4000,  600, 1600,  550, 16, 0,          92 },
+	{ "LG",        LG,        PDIST,  8000, 4000,  600, 1600,  550, 28, 0x8800347,  93 },
+	{ "Denon",     DENON,     PDIST,   300,  750,  300, 1800,  750, 14, 0,          93 },
+	{ "Panasonic", PANASONIC, PDIST,  3502, 1750,  502, 1244,  400, 48, 0,          98 },
+	{ "Sony",      SONY,      PWIDTH, 2400,  600,  600, 1200,  600, 12, 0,          92 },
+	{ "RC5",       RC5,       BIRC5,     0,    0,  889,    0,    0, 12, 0,          93 },
+	{ "RC6",       RC6,       BIRC6,  2666,  889,  444,    0,    0, 20, 0,          84 },
+	{ "Unknown",   UNKNOWN,   NOISY,     0,    0,    0,    0,    0, 40, 0,         100 },
+};
+
+//------------------------------------------------------------------------------
+// Repeatable random numbers, lo to hi - 1
+//
+static unsigned long  seed = 1;
+
+static long  rnd (long lo,  long hi)
+{
+	seed = seed * 1103515245UL + 12345;
+	return lo + (long)(((seed >> 8) & 0xFFFFFF) % (unsigned long)(hi - lo));
+}
+
+//------------------------------------------------------------------------------
+// The frame being made, in ticks, laid out as the receiver records it: raw[0]
+//   is the gap before it
+//
+static unsigned int  raw[RAWBUF];
+static unsigned int  rawlen;
+static bool          lastMark;
+
+// A mark or space of us microseconds, give or take JITTER percent
+static void  add (bool mark,  unsigned int us)
+{
+	if (rawlen >= RAWBUF)  return ;
+	long  t = (long)us * (100 + rnd(-JITTER, JITTER + 1)) / 100;
+	t += mark ? MARK_EXCESS : -MARK_EXCESS;
+	if (t < USECPERTICK)  t = USECPERTICK ;
+	if ((mark == lastMark) && (rawlen > 1))  raw[rawlen - 1] += t / USECPERTICK ;  // Bi-phase: same level again
+	else                                     raw[rawlen++]    = t / USECPERTICK ;
+	lastMark = mark;
+}
+
+// A frame of protocol p carrying a value; returns the value decode() should find
+static unsigned long  frame (int n)
+{
+	unsigned long  value = protos[n].fixed ? protos[n].fixed : ((unsigned long)rnd(0, 0x10000) << 16) | rnd(0, 0x10000);
+	unsigned int   bits  = protos[n].bits;
+	if (bits < 32)  value &= (1UL << bits) - 1 ;
+
+	// The gap before the frame, long enough not to look like a repeat
+	rawlen = 1;
+	raw[0] = 100000 / USECPERTICK;
+	lastMark = false;
+
+	switch (protos[n].shape) {
+		case PDIST:
+			add(true, protos[n].hdrMark);
+			add(false, protos[n].hdrSpace);
+			for (int i = bits - 1;  i >= 0;  i--) {
+				// Panasonic sends a fixed 16 bit address before its 32 bits of data
+				bool  bit = (i < 32) ? ((value >> i) & 1) : ((0x4004 >> (i - 32)) & 1);
+				add(true, protos[n].bitMark);
+				add(false, bit ? protos[n].one : protos[n].zero);
+			}
+			add(true, protos[n].bitMark);
+			break;
+
+		case PWIDTH:
+			add(true, protos[n].hdrMark);
+			for (int i = bits - 1;  i >= 0;  i--) {
+				add(false, protos[n].hdrSpace);
+				add(true, ((value >> i) & 1) ? protos[n].one : protos[n].zero);
+			}
+			break;
+
+		case BIRC5:
+			add(true, protos[n].bitMark);
+			add(false, protos[n].bitMark);
+			add(true, protos[n].bitMark);
+			for (int i = bits - 1;  i >= 0;  i--) {
+				bool  bit = (value >> i) & 1;
+				add(!bit, protos[n].bitMark);
+				add(bit, protos[n].bitMark);
+			}
+			break;
+
+		case BIRC6:
+			add(true, protos[n].hdrMark);
+			add(false, protos[n].hdrSpace);
+			add(true, protos[n].bitMark);
+			add(false, protos[n].bitMark);
+			for (int i = bits - 1;  i >= 0;  i--) {
+				bool          bit = (value >> i) & 1;
+				unsigned int  t   = (i == (int)bits - 4) ? 2 * protos[n].bitMark : protos[n].bitMark;
+				add(bit, t);
+				add(!bit, t);
+			}
+			break;
+
+		case NOISY:
+			for (unsigned int i = 0;  i < bits;  i++)  add(!(i & 1), rnd(200, 3000)) ;
+			break;
+	}
+
+	if (!lastMark)  rawlen-- ;  // A frame ends with its last mark
+
+	// A glitch: a mark broken by a one tick space
+	if ((rnd(0, 100) < NOISE) && (rawlen + 2 <= RAWBUF)) {
+		int           at    = 1 + 2 * rnd(0, (rawlen - 1) / 2);  // A mark
+		unsigned int  ticks = raw[at];
+		if (ticks > 2) {
+			for (int i = rawlen - 1;  i > at;  i--)  raw[i + 2] = raw[i] ;
+			raw[at]     = ticks / 2;
+			raw[at + 1] = 1;
+			raw[at + 2] = ticks - ticks / 2 - 1;
+			rawlen += 2;
+		}
+	}
+
+	unsigned int  us[RAWBUF];
+	for (unsigned int i = 1;  i < rawlen;  i++)  us[i - 1] = raw[i] * USECPERTICK ;
+	simFrame(us, rawlen - 1, (unsigned long)raw[0] * USECPERTICK);
+	return value;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	typedef std::chrono::steady_clock  clock;
+
+	unsigned long  allTime = 0;
+	unsigned long  allFrames = 0;
+	int            fails = 0;
+
+	printf("protocol   decoded  mean nS  worst nS\n");
+	for (unsigned int n = 0;  n < sizeof(protos) / sizeof(protos[0]);  n++) {
+		unsigned int   good  = 0;
+		unsigned long  total = 0;
+		unsigned long  worst = 0;
+
+		for (int f = 0;  f < FRAMES;  f++) {
+			unsigned long  value = frame(n);
+
+			clock::time_point  start   = clock::now();
+			bool               decoded = irrecv.decode(&results);
+			unsigned long      took    = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+			total += took;
+			if (took > worst)  worst = took ;
+			if (decoded && (results.decode_type == protos[n].type)
+			    && ((protos[n].type == UNKNOWN) || ((uint32_t)results.value == (uint32_t)value)))  good++ ;
+			irrecv.resume();
+		}
+		allTime   += total;
+		allFrames += FRAMES;
+
+		bool  ok = (good * 100UL / FRAMES) >= protos[n].minGood;
+		if (!ok)  fails++ ;
+		printf("%-10s %3lu%%  %8lu  %8lu%s\n", protos[n].name, good * 100UL / FRAMES, total / FRAMES, worst, ok ? "" : "  FAIL");
+	}
+
+	printf("All frames: mean nS %lu\n", allTime / allFrames);
+	printf("bench: %d protocols below their minGood: %s\n", fails, fails ? "FAIL" : "ok");
+	return fails ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+//******************************************************************************
+// IRremote host tests
+// The Arduino core of Arduino.h, on a simulated clock; see sim.h
+//******************************************************************************
+
+#include "sim.h"
+
+volatile uint8_t  TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+volatile uint8_t  PORTB, PINB, PORTD, PIND, EIFR, SREG;
+
+HostSerial     Serial;
+bool           simSerial = false;
+bool           simTimer  = true;
+unsigned long  simExcess = 100;
+unsigned long  simNow    = 0;
+
+static int     pinLevel  = HIGH;  // The detector output is active low
+static void  (*pinIsr[2])(void);
+static int     pinMode_[2];
+
+// They are weak so a test can leave out the receive or send interrupt
+extern "C" void  TIMER2_COMPA_vect (void)  __attribute__((weak));
+extern "C" void  TIMER2_OVF_vect   (void)  __attribute__((weak));
+
+//+=============================================================================
+// One uS
+//
+static void  simStep ( )
+{
+	static unsigned long  offSince = 0;
+	static bool           wasOn    = false;
+	static bool           inIsr    = false;  // Interrupts don't nest
+	static bool           inTimer  = false;
+	static unsigned long  cycles   = 0;
+
+	simNow++;
+
+	// The carrier is on while timer 2 drives the LED pin; the detector
+	//   holds its output low for simExcess after it goes off
+	bool  on = (TCCR2A & _BV(COM2B1)) != 0;
+	if (wasOn && !on)  offSince = simNow ;
+	wasOn = on;
+
+	int   level   = (on || (offSince && (simNow - offSince < simExcess))) ? LOW : HIGH;
+	bool  changed = (level != pinLevel);
+	pinLevel = level;
+	PIND = PINB = (level ? 0xFF : 0x00);
+
+	if (!inIsr) {
+		for (int i = 0;  i < 2;  i++) {
+			int  m = pinMode_[i];
+			if (pinIsr[i] && (   ((m == CHANGE)  && changed)
+			                  || ((m == FALLING) && changed && !level)
+			                  || ((m == RISING)  && changed && level)
+			                  || ((m == LOW)     && !level))) {
+				inIsr = true;
+				pinIsr[i]();
+				inIsr = false;
+			}
+		}
+	}
+
+	// The send queue's overflow interrupt: phase correct PWM overflows every
+	//   2 * OCR2A clocks, fast PWM every OCR2A + 1, at 16 clocks per uS
+	static const unsigned  prescale[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+	unsigned  period = ((TCCR2A & _BV(WGM21)) ? OCR2A + 1u : 2u * OCR2A) * prescale[TCCR2B & 7];
+	// The ISRs call micros() too, which must not run them again!
+	if ((TIMSK2 & _BV(TOIE2)) && TIMER2_OVF_vect && period) {
+		cycles += 16;
+		if (!inTimer) {
+			inTimer = true;
+			for (;  cycles >= period;  cycles -= period)  TIMER2_OVF_vect() ;
+			inTimer = false;
+		}
+	}
+
+	// The receive timer
+	if (simTimer && !inTimer && (TIMSK2 & _BV(OCIE2A)) && TIMER2_COMPA_vect && ((simNow % USECPERTICK) == 0)) {
+		inTimer = true;
+		TIMER2_COMPA_vect();
+		inTimer = false;
+	}
+}
+
+//+=============================================================================
+void  simIdle (unsigned long us)
+{
+	while (us--)  simStep() ;
+}
+
+//+=============================================================================
+// Append a duration to the frame, as irRecord() in IRremote.cpp does: with
+//   IR_COMPACT_RAWBUF a long one goes in the side table
+//
+static void  simRecord (unsigned long ticks)
+{
+	if (ticks > 0xFFFF)  ticks = 0xFFFF ;
+#ifdef IR_COMPACT_RAWBUF
+	if (irparams.rawlen == 0)  irparams.nlongs = 0 ;
+	if (ticks >= RAWBUF_ESCAPE) {
+		if (irparams.nlongs < RAWBUF_LONGS) {
+			irparams.longs[irparams.head][irparams.nlongs] = ticks;
+			ticks = RAWBUF_ESCAPE + irparams.nlongs++;
+		} else {
+			ticks = RAWBUF_ESCAPE - 1;
+		}
+	}
+#endif
+	irparams.rawbuf[irparams.rawlen++] = ticks;
+}
+
+//+=============================================================================
+void  simFrame (const unsigned int *us,  int len,  unsigned long gap)
+{
+	irparams.rawlen = 0;
+	simRecord(gap / USECPERTICK);
+	for (int i = 0;  (i < len) && (irparams.rawlen < RAWBUF);  i++) {
+		simRecord((us[i] < USECPERTICK) ? 1 : (us[i] / USECPERTICK));
+	}
+	irparams.rcvstate = STATE_STOP;
+}
+
+//+=============================================================================
+// The core
+//
+unsigned long  micros ( )                     { simStep();  return simNow; }
+unsigned long  millis ( )                     { return simNow / 1000; }
+void           delay  (unsigned long ms)      { simIdle(ms * 1000); }
+void           delayMicroseconds (unsigned int us)  { simIdle(us); }
+
+int   digitalRead  (uint8_t)           { return pinLevel; }
+void  digitalWrite (uint8_t,  uint8_t) { }
+void  pinMode      (uint8_t,  uint8_t) { }
+
+void  attachInterrupt (int num,  void (*isr)(void),  int mode)  { pinIsr[num] = isr;  pinMode_[num] = mode; }
+void  detachInterrupt (int num)                                 { pinIsr[num] = 0; }
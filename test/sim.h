@@ -0,0 +1,26 @@
+//******************************************************************************
+// IRremote host tests
+// A simulated clock, with the IR LED looped back to the receiver pin
+// Each simulated uS the demodulator output follows the carrier (marks come
+//   out simExcess uS long, as from a real detector), the pin change interrupt
+//   sees any edge, and every USECPERTICK uS the receive timer interrupt runs.
+//******************************************************************************
+
+#ifndef sim_h
+#define sim_h
+
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+extern bool           simTimer;   // Run the receive timer interrupt (default on)
+extern unsigned long  simExcess;  // How much longer a received mark is, in uS (100)
+extern unsigned long  simNow;     // The time, in uS
+
+void  simIdle (unsigned long us) ;  // Let us uS pass
+
+// Put a frame straight into the first receiver's buffer, as if it had just
+//   recorded it: a gap of gap uS, then the len marks & spaces of us[], in uS
+//   as received (as IRrecvDumpV2 prints them)
+void  simFrame (const unsigned int *us,  int len,  unsigned long gap = 100000) ;
+
+#endif
@@ -0,0 +1,188 @@
+//******************************************************************************
+// IRremote host tests
+// candidates() may only rule out a decoder which could not have matched:
+//   every decoder is run on 400000 made up frames (near misses of each
+//   protocol, with jitter, wrong lengths and plain noise), and none may take
+//   a frame candidates() left it out for.
+//******************************************************************************
+
+#include "sim.h"
+
+#define FRAMES  400000
+
+class Probe : public IRrecv
+{
+	public:
+		Probe (int recvpin) : IRrecv(recvpin) { }
+
+		using IRrecv::fetch;
+		using IRrecv::candidates;
+};
+
+Probe           irrecv(2);
+decode_results  results;
+
+static unsigned long  seed = 12345;
+
+static unsigned int  rnd (unsigned int n)
+{
+	seed = seed * 1103515245UL + 12345;
+	return ((seed >> 8) & 0xFFFFFF) % n;
+}
+
+// The shapes of the frames: a header, then bits of a mark and either of two
+//   spaces (pulse distance), or of either of two marks and a space (pulse width)
+static const struct {
+	unsigned int  hdrMark, hdrSpace, bitMark, one, zero;
+	int           bits;
+	bool          distance;
+}
+shapes[] = {
+	{ 9000, 4500,  560, 1690,  560, 32, true  },  // NEC
+	{ 9000, 2250,  560,    0,    0,  0, true  },  // ... repeat
+	{ 2400,  600,  600, 1200,  600, 12, false },  // Sony
+	{ 3500, 3500,  950, 2400,  700, 12, false },  // Sanyo
+	{  350,    0,    0, 1950,  750, 16, false },  // Mitsubishi
+	{  889,  889,  889,  889,  889, 13, true  },  // RC5
+	{ 2666,  889,  444,  444,  444, 20, true  },  // RC6
+	{ 3502, 1750,  502, 1244,  400, 48, true  },  // Panasonic
+	{ 8000, 4000,  600, 1600,  550, 28, true  },  // LG
+	{ 8000, 4000,  600, 1600,  550, 16, true  },  // JVC
+	{  600,    0,  600, 1600,  550, 16, true  },  // ... repeat
+	{ 5000, 5000,  560, 1600,  560, 32, true  },  // Samsung
+	{ 5000, 2250,  560,    0,    0,  0, true  },  // ... repeat
+	{  750,  750,  750, 2150,  750, 34, true  },  // Whynter
+	{ 8800, 4500,  500,  600, 1700, 42, true  },  // Aiwa RC-T501
+	{  300,  750,  300, 1800,  750, 14, true  },  // Denon
+	{  315,  315,  315,  630,  315, 20, true  },  // rStep 38kHz
+	{  213,  213,  213,  426,  213, 20, true  },  // rStep 56kHz
+};
+
+//+=============================================================================
+// A made up frame, in ticks, straight into the receiver's buffer
+//
+static void  frame ( )
+{
+	unsigned int  us[RAWBUF];
+	int           len   = 0;
+	int           shape = rnd(sizeof(shapes) / sizeof(shapes[0]));
+	int           pert  = rnd(4) ? 5 : 40;  // Percent of jitter
+	int           bits  = shapes[shape].bits + (rnd(3) ? 0 : (int)rnd(5) - 2);
+
+#	define ADD(t, mark)                                                            \
+		do {                                                                        \
+			long  u = (long)(t) * (100 + (int)rnd(2 * pert + 1) - pert) / 100        \
+			          + ((mark) ? MARK_EXCESS : -MARK_EXCESS);                       \
+			if (u < USECPERTICK)  u = USECPERTICK + rnd(2 * USECPERTICK) ;           \
+			if (len < RAWBUF - 1)  us[len++] = u ;                                    \
+		} while (0)
+
+	ADD(shapes[shape].hdrMark, true);
+	if (shapes[shape].hdrSpace)  ADD(shapes[shape].hdrSpace, false) ;
+	for (int i = 0;  i < bits;  i++) {
+		bool  one = rnd(2);
+		if (shapes[shape].distance) {
+			ADD(shapes[shape].bitMark, true);
+			ADD(one ? shapes[shape].one : shapes[shape].zero, false);
+		} else {
+			ADD(one ? shapes[shape].one : shapes[shape].zero, true);
+			ADD(shapes[shape].hdrSpace, false);
+		}
+	}
+	if (shapes[shape].bitMark && rnd(4))  ADD(shapes[shape].bitMark, true) ;
+
+	// Now and then just noise
+	if (!rnd(10)) {
+		len = rnd(RAWBUF - 1);
+		for (int i = 0;  i < len;  i++)  us[i] = USECPERTICK * (rnd(4) ? 1 + rnd(60) : rnd(400)) ;
+	}
+	if ((len % 2) == 0 && len && rnd(2))  len-- ;
+
+	// The gap before it, which Sony & Sanyo look at for repeats
+	simFrame(us, len, (unsigned long)USECPERTICK * (rnd(3) ? 100 + rnd(3000) : rnd(1000)));
+}
+
+//+=============================================================================
+// Run one decoder on a copy of the frame, whatever candidates() said
+//
+static int  skipped, fails;
+
+template <decode_type_t T>
+static void  check (const char *name,  unsigned long cand)
+{
+	decode_results  copy = results;
+
+	if (cand & CANDIDATE(T))  return ;
+	skipped++;
+	if (IRdecoder<T>::decode(irrecv, &copy, ~0UL)) {
+		if (fails++ < 10) {
+			printf("FAIL: candidates() ruled out %s, which takes this frame:", name);
+			for (int i = 0;  i < results.rawlen;  i++)  printf(" %u", (unsigned int)results.rawbuf[i]) ;
+			printf("\n");
+		}
+	}
+}
+
+#define CHECK(type)  check<type>(#type, cand)
+
+//+=============================================================================
+int  main ( )
+{
+	for (long n = 0;  n < FRAMES;  n++) {
+		frame();
+		irrecv.fetch(&results);
+		unsigned long  cand = irrecv.candidates(&results);
+
+#if DECODE_NEC
+		CHECK(NEC);
+#endif
+#if DECODE_SONY
+		CHECK(SONY);
+#endif
+#if DECODE_SANYO
+		CHECK(SANYO);
+#endif
+#if DECODE_MITSUBISHI
+		CHECK(MITSUBISHI);
+#endif
+#if DECODE_RC5
+		CHECK(RC5);
+#endif
+#if DECODE_RC6
+		CHECK(RC6);
+#endif
+#if DECODE_PANASONIC
+		CHECK(PANASONIC);
+#endif
+#if DECODE_LG
+		CHECK(LG);
+#endif
+#if DECODE_JVC
+		CHECK(JVC);
+#endif
+#if DECODE_SAMSUNG
+		CHECK(SAMSUNG);
+#endif
+#if DECODE_WHYNTER
+		CHECK(WHYNTER);
+#endif
+#if DECODE_AIWA_RC_T501
+		CHECK(AIWA_RC_T501);
+#endif
+#if DECODE_DENON
+		CHECK(DENON);
+#endif
+#if DECODE_RSTEP
+		CHECK(RSTEP);
+#endif
+#if DECODE_LEGO_PF
+		CHECK(LEGO_PF);
+#endif
+
+		irrecv.resume();
+	}
+
+	printf("test_candidates: %d frames, %d decoder calls skipped, %d wrongly: %s\n",
+	       FRAMES, skipped, fails, fails ? "FAIL" : "ok");
+	return fails ? 1 : 0;
+}
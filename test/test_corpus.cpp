@@ -0,0 +1,98 @@
+//******************************************************************************
+// IRremote host tests
+// decode() must still make of each recorded frame in the corpus what it was:
+//   test_corpus corpus/*.txt
+// Each line of a corpus file is the protocol, value (hex) and bits decode()
+//   should report, then the marks & spaces of the frame in uS, as received.
+//******************************************************************************
+
+#include "sim.h"
+
+IRrecv          irrecv(2);
+decode_results  results;
+
+static const struct {
+	const char    *name;
+	decode_type_t  type;
+}
+protocols[] = {
+	{ "NEC",       NEC       },  { "SONY",      SONY      },  { "RC5",       RC5       },
+	{ "RC6",       RC6       },  { "PANASONIC", PANASONIC },  { "JVC",       JVC       },
+	{ "SAMSUNG",   SAMSUNG   },  { "WHYNTER",   WHYNTER   },  { "LG",        LG        },
+	{ "DENON",     DENON     },  { "RSTEP",     RSTEP     },  { "UNKNOWN",   UNKNOWN   },
+};
+
+//+=============================================================================
+static bool  protocolType (const char *name,  decode_type_t *type)
+{
+	for (unsigned int i = 0;  i < sizeof(protocols) / sizeof(protocols[0]);  i++) {
+		if (!strcmp(name, protocols[i].name)) {
+			*type = protocols[i].type;
+			return true;
+		}
+	}
+	return false;
+}
+
+//+=============================================================================
+// Test the frames of one corpus file; returns the failures
+//
+static int  testFile (const char *path,  int *frames)
+{
+	FILE  *f = fopen(path, "r");
+	char   line[4096];
+	int    fails = 0;
+	int    n     = 0;
+
+	if (!f) {
+		printf("%s: cannot open\n", path);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		char           name[20];
+		unsigned long  value;
+		int            bits, used;
+		decode_type_t  type;
+		unsigned int   us[RAWBUF];
+		int            len = 0;
+		const char    *p   = line;
+
+		n++;
+		if ((line[0] == '#') || (line[0] == '\n'))  continue ;
+		if ((sscanf(p, "%19s %lx %d%n", name, &value, &bits, &used) != 3) || !protocolType(name, &type)) {
+			printf("%s:%d: bad line\n", path, n);
+			fails++;
+			continue;
+		}
+		for (p += used;  (len < RAWBUF - 1) && (sscanf(p, "%u%n", &us[len], &used) == 1);  p += used)  len++ ;
+
+		simFrame(us, len);
+		bool  ok = irrecv.decode(&results)
+		           && (results.decode_type == type)
+		           && ((results.value & 0xFFFFFFFFUL) == value)
+		           && (results.bits == bits);
+		if (!ok) {
+			printf("%s:%d: FAIL, want %s %lX %d, got %d %lX %d\n", path, n, name, value, bits,
+			       results.decode_type, results.value & 0xFFFFFFFFUL, results.bits);
+			fails++;
+		}
+		irrecv.resume();
+		(*frames)++;
+	}
+
+	fclose(f);
+	return fails;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	int  fails  = 0;
+	int  frames = 0;
+
+	for (int i = 1;  i < argc;  i++)  fails += testFile(argv[i], &frames) ;
+
+	printf("test_corpus: %d frames, %d failed: %s\n", frames, fails, fails ? "FAIL" : "ok");
+	return fails ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+//******************************************************************************
+// IRremote host tests
+// Pronto codes (irPronto.cpp): compilePronto() must take good codes and turn
+//   down bad ones, and what sendPronto() sends must come back through the
+//   receiver.  The receiver runs on the pin change interrupt, as the send
+//   carrier has the timer.
+//******************************************************************************
+
+#include "sim.h"
+
+IRrecv          irrecv(2);
+IRsend          irsend;
+decode_results  results;
+
+static int  fails = 0;
+
+// A Denon code: no "once" part, a "repeat" part of 50 pairs
+static const char  denon[] PROGMEM =
+	"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
+	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
+	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
+	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
+	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
+	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
+	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
+	"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
+	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
+	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
+	"0010 0030 0010 0aa6";                               // 104
+
+// NEC 0x20DF10EF, as the "repeat" part
+static char  nec[] =
+	"0000 006D 0000 0022 0156 00AB 0015 0015 0015 0015 0015 0040 0015 0015 0015 0015 "
+	"0015 0015 0015 0015 0015 0015 0015 0040 0015 0040 0015 0015 0015 0040 0015 0040 "
+	"0015 0040 0015 0040 0015 0040 0015 0015 0015 0015 0015 0015 0015 0040 0015 0015 "
+	"0015 0015 0015 0015 0015 0015 0015 0040 0015 0040 0015 0040 0015 0015 0015 0040 "
+	"0015 0040 0015 0040 0015 0040 0015 05F1";
+
+//+=============================================================================
+static void  expect (bool ok,  const char *what)
+{
+	if (!ok) {
+		printf("FAIL: %s\n", what);
+		fails++;
+	}
+}
+
+//+=============================================================================
+// What came back, if anything
+//
+static bool  received ( )
+{
+	simIdle(20000);
+	bool  got = irrecv.decode(&results);
+	irrecv.resume();
+	simIdle(100000);
+	return got;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	ProntoCode    p;
+	unsigned int  buf[120];
+
+	simTimer = false;
+	irrecv.enableIRIn(true);
+	simIdle(60000);
+
+	// Parsing
+	expect(irsend.compilePronto_P(denon, &p, buf, 120), "compile the Denon code");
+	expect((p.hz == 37010) && (p.once == 0) && (p.rpt == 50) && (buf[0] == 3459), "the Denon code's carrier, lengths and first mark");
+	expect(!irsend.compilePronto_P(denon, &p, buf, 99), "a buffer too small");
+	expect(!irsend.compilePronto("0000 0070 0000 0001 0010", &p, buf, 120), "too few words");
+	expect(!irsend.compilePronto("0000 0070 0000 0001 0010 0010 0010", &p, buf, 120), "too many words");
+	expect(!irsend.compilePronto("0100 0070 0000 0001 0010 0010", &p, buf, 120), "not a learned code");
+	expect(!irsend.compilePronto("0000 0070 0000 0001 0010 001G", &p, buf, 120), "not hex");
+	expect(irsend.compilePronto("  0000 0070\t0000 0001 0010 0010  ", &p, buf, 120), "blanks around the words");
+
+	// Sending, compiled and from the string
+	expect(irsend.compilePronto(nec, &p, buf, 120), "compile the NEC code");
+	irsend.sendPronto(&p, PRONTO_REPEAT, PRONTO_FALLBACK);
+	expect(received() && (results.decode_type == NEC) && (results.value == 0x20DF10EF), "send the NEC code compiled");
+	irsend.sendPronto(nec, PRONTO_REPEAT, PRONTO_FALLBACK);
+	expect(received() && (results.decode_type == NEC) && (results.value == 0x20DF10EF), "send the NEC code from its string");
+	irsend.sendPronto(&p, PRONTO_ONCE, PRONTO_FALLBACK);
+	expect(received() && (results.decode_type == NEC), "fall back to the repeat part");
+	irsend.sendPronto(&p, PRONTO_ONCE, PRONTO_NOFALLBACK);
+	expect(!received(), "no once part, and no fall back");
+
+	irsend.compilePronto_P(denon, &p, buf, 120);
+	irsend.sendPronto(&p, PRONTO_REPEAT, PRONTO_NOFALLBACK);
+	expect(received() && (results.rawlen == 100), "send the Denon code");
+
+#if SENDBUF
+	expect(irsend.compilePronto(nec, &p, buf, 120), "compile the NEC code again");
+	expect(irsend.sendProntoAsync(&p, PRONTO_REPEAT, PRONTO_FALLBACK), "queue the NEC code");
+	while (irsend.isSendBusy())  simIdle(100) ;
+	expect(received() && (results.decode_type == NEC) && (results.value == 0x20DF10EF), "send the NEC code from the queue");
+#endif
+
+	printf("test_pronto: %d failed: %s\n", fails, fails ? "FAIL" : "ok");
+	return fails ? 1 : 0;
+}
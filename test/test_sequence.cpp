@@ -0,0 +1,135 @@
+//******************************************************************************
+// IRremote host tests
+// Codes rendered ahead of time (irSend.cpp): encode() must give each send's
+//   marks & spaces, carrier and gap, and turn down a buffer too small; what
+//   sendSequence() sends must come back through the receiver, and take each
+//   code's period.  The receiver runs on the pin change interrupt, as the
+//   send carrier has the timer.
+//******************************************************************************
+
+#include "sim.h"
+
+IRrecv          irrecv(2);
+IRsend          irsend;
+decode_results  results;
+
+static int  fails = 0;
+
+//+=============================================================================
+static void  expect (bool ok,  const char *what)
+{
+	if (!ok) {
+		printf("FAIL: %s\n", what);
+		fails++;
+	}
+}
+
+//+=============================================================================
+// uS from the start of a frame to the start of the next
+//
+static unsigned long  period (const IRframe *f)
+{
+	unsigned long  t = f->gap;
+
+	for (unsigned int i = 0;  i < f->len;  i++)  t += f->data[i] ;
+	return t;
+}
+
+//+=============================================================================
+// Whether the next code to come back is type & value; then a gap before the
+//   next, not to look like a repeat
+//
+static bool  received (decode_type_t type,  unsigned long value)
+{
+	for (unsigned long waited = 0;  waited < 200000;  waited += 1000) {
+		simIdle(1000);
+		if (irrecv.decode(&results)) {
+			bool  ok = (results.decode_type == type) && (results.value == value);
+			irrecv.resume();
+			simIdle(100000);
+			return ok;
+		}
+	}
+	return false;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	IRframe       fr[4];
+	unsigned int  buf[4][100];
+
+	simTimer = false;
+	irrecv.enableIRIn(true);
+	simIdle(60000);
+
+	// Rendering
+	expect(irsend.encode(&fr[0], buf[0], 100, &IRsend::sendNEC, 0x20DF10EFUL, 32), "encode an NEC code");
+	expect((fr[0].len == 67) && (fr[0].hz == 38000) && (period(&fr[0]) == NEC_RPT_LENGTH), "the NEC code's length, carrier and period");
+	expect(irsend.encode(&fr[1], buf[1], 100, &IRsend::sendSony, 0xA90UL, 12), "encode a Sony code");
+	expect((fr[1].len == 25) && (fr[1].hz == 40000), "the Sony code's length and carrier");
+	expect(fr[1].duty == IR_DUTY_33, "the Sony code's duty cycle");
+	expect(irsend.encode(&fr[2], buf[2], 100, &IRsend::sendRC5, 0x10CUL, 12), "encode an RC5 code");
+	expect((fr[2].hz == 36000) && (period(&fr[2]) == RC5_RPT_LENGTH), "the RC5 code's carrier and period");
+	expect(irsend.encode(&fr[3], buf[3], 100, &IRsend::sendJVC, 0xC5E8UL, 16, false), "encode a JVC code");
+	expect(!irsend.encode(&fr[3], buf[3], 20, &IRsend::sendNEC, 0x20DF10EFUL, 32), "a buffer too small");
+	irsend.encode(&fr[3], buf[3], 100, &IRsend::sendJVC, 0xC5E8UL, 16, false);
+
+	// The duty cycle a code was rendered with is the one it is sent with
+	IRframe       duty;
+	unsigned int  dbuf[4];
+	irsend.encodeBegin(&duty, dbuf, 4);
+	irsend.enableIROutHz(38000, IR_DUTY_50);
+	irsend.mark(560);
+	expect(irsend.encodeEnd() && (duty.duty == IR_DUTY_50), "encode with a duty cycle of a half");
+	irsend.enableIROutHz(38000, IR_DUTY_50);
+	uint8_t  half  = OCR2B;
+	irsend.enableIROutHz(38000);
+	uint8_t  third = OCR2B;
+	irsend.sendSequence(&duty, 1);
+	expect((half != third) && (OCR2B == half), "send with a duty cycle of a half");
+	simIdle(100000);
+
+	// Sending; the receiver keeps only the first code until resume(), so one
+	//   at a time
+	irsend.sendSequence(&fr[0], 1);
+	expect(received(NEC, 0x20DF10EF), "send the NEC code");
+	irsend.sendSequence(&fr[1], 1);
+	expect(received(SONY, 0xA90), "send the Sony code");
+	irsend.sendSequence(&fr[2], 1);
+	expect(received(RC5, 0x10C), "send the RC5 code");
+	irsend.sendSequence(&fr[3], 1);
+	expect(received(JVC, 0xC5E8), "send the JVC code");
+
+	// The second code starts one period after the first
+	unsigned long  start = simNow;
+	irsend.sendSequence(fr, 2);
+	long  late = (long)(simNow - start) - (long)(period(&fr[0]) + period(&fr[1]) - fr[1].gap);
+	expect((late > -100) && (late < 100), "send the Sony code a period after the NEC code");
+	expect(received(NEC, 0x20DF10EF), "send the NEC code of the sequence");
+
+#if SENDBUF
+	expect(irsend.sendSequenceAsync(fr, 1), "queue the NEC code");
+	while (irsend.isSendBusy())  simIdle(100) ;
+	expect(received(NEC, 0x20DF10EF), "send the NEC code from the queue");
+	IRframe  many[SENDBUF / 67 + 1];  // More NEC codes than the queue can hold
+	for (unsigned int n = 0;  n < sizeof(many) / sizeof(many[0]);  n++)  many[n] = fr[0] ;
+	expect(!irsend.sendSequenceAsync(many, sizeof(many) / sizeof(many[0])), "refuse a sequence bigger than the queue");
+	expect(!irsend.isSendBusy(), "nothing queued of it");
+
+	// Too fast a carrier for the send interrupt: sent blocking, or refused if
+	//   it comes after a code already queued
+	IRframe  fast[2] = { fr[0], fr[0] };
+	fast[0].hz = SEND_INTR_MAX_HZ + 1000;
+	simIdle(100000);
+	expect(irsend.sendSequenceAsync(fast, 1), "send a fast carrier code blocking");
+	expect(!irsend.isSendBusy() && received(NEC, 0x20DF10EF), "the fast carrier code, sent");
+	fast[0].hz = fr[0].hz;
+	fast[1].hz = SEND_INTR_MAX_HZ + 1000;
+	expect(!irsend.sendSequenceAsync(fast, 2), "refuse a fast carrier after a queued code");
+	expect(!irsend.isSendBusy(), "nothing queued of that");
+#endif
+
+	printf("test_sequence: %d failed: %s\n", fails, fails ? "FAIL" : "ok");
+	return fails ? 1 : 0;
+}